@@ -1,45 +1,265 @@
 #include "fashion_driver.h"
+#include "scan_scheduler.h"
+#include "uart_tx_ring.h"
+#include "perf_probe.h"
 
-uint8_t packet[FRAMESIZE];
 uint16_t angle_read;
 
+// 在途角度指令的应答收集位图：发送时置位各目标ID，回包逐个清位，
+// 清空即全部就位——多轴机头的组指令与单舵机共用同一套完成判定
+volatile uint8_t fashion_ack_mask = 0;
+
+// 舵机指令队列：固定槽位报文池 + huart1链式DMA发送
+// 发送方不再共用单个全局packet缓冲，连发指令按序排队而不会相互覆盖
+typedef struct {
+	uint8_t data[FASHION_MAX_PACKET_LENGTH];	//报文内容
+	uint8_t length;														//报文长度
+}FashionCmd;
+
+static FashionCmd fashion_queue[FASHION_QUEUE_DEPTH];
+static volatile uint8_t fashion_q_head = 0;		//入队位置（只增）
+static volatile uint8_t fashion_q_tail = 0;		//DMA消费位置
+static volatile uint8_t fashion_q_busy = 0;		//DMA在途标志
+volatile uint32_t fashion_q_dropped = 0;			//队列满丢弃计数
+static volatile uint32_t fashion_rtt_start = 0;	//当前在途指令的发出时刻(DWT周期)
+static volatile uint8_t fashion_rtt_armed = 0;	//在途指令尚未收到应答，回包才计一次RTT
+
+// 轨迹流：整程位置序列在扫描开始时一次性下放到舵机层，
+// 当前点确认到位的回包中断里即预构建下一点报文，
+// 扫描状态机完成本点工作后fashion_traj_advance()零构建延迟上总线
+static volatile uint8_t traj_active = 0;			//轨迹流是否在执行
+static int16_t traj_low = 0;									//扫描位置下限
+static int16_t traj_high = 0;									//扫描位置上限
+static int16_t traj_div = 0;									//扫描步距
+static uint16_t traj_time = 0;								//单步运动时间(ms)
+static volatile int16_t traj_target_pos = 0;	//当前目标位置
+static int16_t traj_next_pos = 0;							//预取的下一目标位置
+static uint8_t traj_dir = 1;									//1正向扫描 0反向扫描
+static uint8_t traj_next_packet[FASHION_MAX_PACKET_LENGTH];	//预构建的下一点报文
+static uint8_t traj_next_length = 0;					//预构建报文长度
+
+static uint8_t fashion_build_single_angle(uint8_t *packet, uint8_t servo_id,
+                                          int16_t angle, uint16_t time_ms);
+
+/**
+ * @brief 启动队首指令的DMA发送
+ * @note 仅在临界区内或发送完成回调中调用
+ */
+static void fashion_kick(void)
+{
+    if(fashion_q_head != fashion_q_tail)
+    {
+        FashionCmd *cmd = &fashion_queue[fashion_q_tail & (FASHION_QUEUE_DEPTH - 1)];
+        fashion_q_busy = 1;
+        fashion_rtt_start = perfNow();  //往返计时起点：指令上总线
+        fashion_rtt_armed = 1;
+        HAL_UART_Transmit_DMA(&huart1, cmd->data, cmd->length);
+    }
+    else
+    {
+        fashion_q_busy = 0;
+    }
+}
+
+/**
+ * @brief 指令入队，链路空闲时立即启动发送
+ * @param data 报文数据
+ * @param length 报文长度
+ */
+static void fashion_enqueue(const uint8_t *data, uint8_t length)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if((uint8_t)(fashion_q_head - fashion_q_tail) >= FASHION_QUEUE_DEPTH)
+    {
+        ++fashion_q_dropped;    //队列满，丢弃本条指令
+    }
+    else
+    {
+        FashionCmd *cmd = &fashion_queue[fashion_q_head & (FASHION_QUEUE_DEPTH - 1)];
+        memcpy(cmd->data, data, length);
+        cmd->length = length;
+        ++fashion_q_head;
+        if(fashion_q_busy == 0)
+        {
+            fashion_kick();
+        }
+    }
+    if(primask == 0)
+    {
+        __enable_irq();
+    }
+}
+
+/**
+ * @brief huart1发送完成处理：释放队首槽位并链式发送下一条
+ * @note 在huart1的发送完成回调中调用
+ */
+void fashion_tx_complete(void)
+{
+    ++fashion_q_tail;
+    fashion_kick();
+}
+
+// 零拷贝接收扫描：直接在ReceiveBuff1循环DMA缓冲区上定位与校验回包，
+// 不再经recv_frame1中转——一次空闲事件里连发的多帧逐个处理不丢帧
+static uint16_t fashion_rx_tail = 0;		//扫描消费位置（环内偏移）
+static uint16_t fashion_rx_base = 0;		//当前帧起点（环内偏移）
+volatile uint32_t fashion_rx_crc_errors = 0;	//舵机回包校验和失败计数
+
+/**
+ * @brief 按环内偏移读当前帧的第offset个字节（处理缓冲区回绕）
+ * @param offset 帧内偏移
+ * @return 字节值
+ */
+static uint8_t fashion_rx_at(uint8_t offset)
+{
+    uint16_t index = (uint16_t)(fashion_rx_base + offset);
+    if(index >= BUFFERSIZE)
+    {
+        index -= BUFFERSIZE;
+    }
+    return ReceiveBuff1[index];
+}
+
+/**
+ * @brief 将当前帧转发到uart2发送环
+ * @param length 帧长度
+ * @note 帧未回绕时直接从DMA环入发送环；回绕帧先凑齐再入环，
+ *       保证发送环内帧字节连续
+ */
+static void fashion_rx_forward(uint8_t length)
+{
+    if((uint16_t)(fashion_rx_base + length) <= BUFFERSIZE)
+    {
+        txRingSend(&ReceiveBuff1[fashion_rx_base], length);
+    }
+    else
+    {
+        uint8_t tmp[FRAMESIZE];
+        uint8_t first = (uint8_t)(BUFFERSIZE - fashion_rx_base);
+        memcpy(tmp, &ReceiveBuff1[fashion_rx_base], first);
+        memcpy(tmp + first, &ReceiveBuff1[0], (uint8_t)(length - first));
+        txRingSend(tmp, length);
+    }
+}
+
 /**
- * @brief 处理舵机回包数据
- * @param length 数据包长度
- * @return 是否成功处理
+ * @brief 处理一条已通过帧头与校验和检查的舵机回包（原地访问DMA环）
+ * @param length 帧长度
  */
-void fashion_process_response(uint8_t length)
-{    
-    // 检查帧头是否正确
-    if (recv_frame1[0] == FASHION_FRAME_HEADER_RESP_1 && recv_frame1[1] == FASHION_FRAME_HEADER_RESP_2)
-    {      
+static void fashion_process_frame(uint8_t length)
+{
+    // 只对应答在途指令的首个回包计RTT：监控流推送(0x16)不请自来，
+    // 指令间隔期间把它计入只会测出"距上条指令的时间"而非总线往返
+    if (fashion_rtt_armed && fashion_rx_at(2) != FASHION_CMD_DATA_MONITOR)
+    {
+        perfRecord(PERF_FASHION_RTT, fashion_rtt_start);  //指令发出到应答回包的总线往返
+        fashion_rtt_armed = 0;
+    }
+
     // 根据命令ID处理不同类型的回包
-    switch (recv_frame1[2])
+    switch (fashion_rx_at(2))
     {
         case FASHION_CMD_READ_ANGLE: // 角度读取回包 (0x0A)
-						angle_read = ((uint16_t)recv_frame1[6] << 8) | recv_frame1[5];                
+						angle_read = ((uint16_t)fashion_rx_at(6) << 8) | fashion_rx_at(5);
 						flag_fashion = Release;
+						scanEventSet(SCAN_EVT_FASHION_DONE | SCAN_EVT_ANGLE_READ); //通知扫描状态机
             break;
-        case FASHION_CMD_SINGLE_ANGLE: // 角度控制回包 (0x08)  
-						if (recv_frame1[5] == 0x01){                  
-							flag_fashion = Release;
+        case FASHION_CMD_SINGLE_ANGLE: // 角度控制回包 (0x08)
+						if (fashion_rx_at(5) == 0x01 && fashion_rx_at(4) < 8){
+							fashion_ack_mask &= (uint8_t)~(1u << fashion_rx_at(4)); //按舵机ID收集应答(ID>=8不在位图内)
+							if (fashion_ack_mask == 0){
+								flag_fashion = Release;
+								if (traj_active){
+									// 当前点就位：在中断里预构建下一点报文，advance时直接上总线
+									traj_next_length = fashion_build_single_angle(traj_next_packet, 0,
+									                                              traj_next_pos, traj_time);
+									scanEventSet(SCAN_EVT_FASHION_DONE | SCAN_EVT_TRAJ_POINT);
+								}else{
+									scanEventSet(SCAN_EVT_FASHION_DONE); //全部舵机就位，通知扫描状态机
+								}
+							}
 						}
             break;
         case FASHION_CMD_PING: // 通讯检测回包 (0x01)
-						HAL_UART_Transmit_IT(&huart2, recv_frame1, 6);
+						fashion_rx_forward(6);
             break;
         case FASHION_CMD_DATA_READ: // 数据读取回包 (0x03)
-            // 将回包转发到uart2
-            HAL_UART_Transmit_IT(&huart2, recv_frame1, length);
+            // 将回包转发到uart2发送环
+            fashion_rx_forward(length);
             break;
         case FASHION_CMD_DATA_MONITOR: // 数据监控回包 (0x16)
-            // 将回包转发到uart2
-            HAL_UART_Transmit_IT(&huart2, recv_frame1, length);
+            // 角度监控流：维护angle_read实时影子值，扫描状态机按事件推进
+            if (fashion_rx_at(4) == FASHION_MONITOR_ANGLE){
+                angle_read = ((uint16_t)fashion_rx_at(6) << 8) | fashion_rx_at(5);
+                scanEventSet(SCAN_EVT_ANGLE_READ);
+            }
+            // 将回包转发到uart2发送环
+            fashion_rx_forward(length);
             break;
         default:
             break;
     }
-	}
+}
+
+/**
+ * @brief 在ReceiveBuff1循环DMA缓冲区上扫描并分发全部完整回包
+ * @param dma_head DMA当前写入位置（空闲/半满/全满事件回调中的Size）
+ * @note 在huart1接收事件回调中调用，替代原先复制进recv_frame1的路径。
+ *       帧头或校验不匹配时逐字节滑动重同步；尾部不完整的帧留待
+ *       下一次事件继续，跨缓冲区回绕的帧按环内偏移正确拼接
+ */
+void fashion_rx_scan(uint16_t dma_head)
+{
+    while(fashion_rx_tail != dma_head)
+    {
+        uint16_t available = (uint16_t)(dma_head + BUFFERSIZE - fashion_rx_tail) % BUFFERSIZE;
+        uint8_t frame_len;
+        uint16_t sum;
+
+        fashion_rx_base = fashion_rx_tail;
+        // 帧头逐字节同步
+        if(fashion_rx_at(0) != FASHION_FRAME_HEADER_RESP_1)
+        {
+            fashion_rx_tail = (uint16_t)(fashion_rx_tail + 1) % BUFFERSIZE;
+            continue;
+        }
+        if(available < 4)
+        {
+            break;  //帧头/长度字节未收全，等待下一次事件
+        }
+        if(fashion_rx_at(1) != FASHION_FRAME_HEADER_RESP_2)
+        {
+            fashion_rx_tail = (uint16_t)(fashion_rx_tail + 1) % BUFFERSIZE;
+            continue;
+        }
+        // 帧长 = 帧头2 + 命令 + 长度 + 内容 + 校验和
+        frame_len = (uint8_t)(4 + fashion_rx_at(3) + 1);
+        if(frame_len > FRAMESIZE)
+        {
+            fashion_rx_tail = (uint16_t)(fashion_rx_tail + 1) % BUFFERSIZE;
+            continue;   //长度字段非法，滑动重同步
+        }
+        if(available < frame_len)
+        {
+            break;  //帧尾未收全，等待下一次事件
+        }
+        // 原地校验和（帧头到内容部分求和）
+        sum = 0;
+        for(uint8_t i = 0; i < (uint8_t)(frame_len - 1); i++)
+        {
+            sum += fashion_rx_at(i);
+        }
+        if((uint8_t)sum != fashion_rx_at((uint8_t)(frame_len - 1)))
+        {
+            ++fashion_rx_crc_errors;
+            fashion_rx_tail = (uint16_t)(fashion_rx_tail + 1) % BUFFERSIZE;
+            continue;   //校验失败，滑动重同步
+        }
+        fashion_process_frame(frame_len);
+        fashion_rx_tail = (uint16_t)(fashion_rx_tail + frame_len) % BUFFERSIZE;
+    }
 }
 
 /**
@@ -65,6 +285,7 @@ uint8_t fashion_calculate_checksum(uint8_t *data, uint8_t length)
  */
 void fashion_send_ping(uint8_t servo_id)
 {
+    uint8_t packet[FASHION_MAX_PACKET_LENGTH];
     // 构建数据包
     packet[0] = FASHION_FRAME_HEADER_REQ_1;  // 帧头1
     packet[1] = FASHION_FRAME_HEADER_REQ_2;  // 帧头2
@@ -75,18 +296,20 @@ void fashion_send_ping(uint8_t servo_id)
     // 计算校验和（帧头到内容部分）
     packet[5] = fashion_calculate_checksum(packet, 5);
     
-    // 使用DMA发送数据
-    HAL_UART_Transmit_DMA(&huart1, packet, 6);
+    // 入队，由DMA链式发送
+    fashion_enqueue(packet, 6);
 }
 
 /**
- * @brief 发送单圈角度控制指令
+ * @brief 构建单圈角度控制报文
+ * @param packet 报文输出缓冲区（不小于FASHION_MAX_PACKET_LENGTH）
  * @param servo_id 舵机ID (0-254)
  * @param angle 目标角度（单位：0.1度，例如90.0度 = 900）
  * @param time_ms 运动时间（单位：毫秒）
- * @return HAL状态
+ * @return 报文长度
  */
-void fashion_send_single_angle(uint8_t servo_id, int16_t angle, uint16_t time_ms)
+static uint8_t fashion_build_single_angle(uint8_t *packet, uint8_t servo_id,
+                                          int16_t angle, uint16_t time_ms)
 {
     // 构建数据包
     packet[0] = FASHION_FRAME_HEADER_REQ_1;  // 帧头1
@@ -94,23 +317,209 @@ void fashion_send_single_angle(uint8_t servo_id, int16_t angle, uint16_t time_ms
     packet[2] = FASHION_CMD_SINGLE_ANGLE;    // 指令码
     packet[3] = 0x07;                         // 内容长度（舵机ID + 角度 + 时间 + 功率）
     packet[4] = servo_id;                    // 舵机ID
-    
+
     // 角度值（小端序，16位）
     packet[5] = (uint8_t)(angle & 0xFF);      // 低字节
     packet[6] = (uint8_t)((angle >> 8) & 0xFF); // 高字节
-    
+
     // 时间值（小端序，16位）
     packet[7] = (uint8_t)(time_ms & 0xFF);    // 低字节
     packet[8] = (uint8_t)((time_ms >> 8) & 0xFF); // 高字节
-    
+
     packet[9] = 0x00;                         // 功率
     packet[10] = 0x00;                         // 功率
 
     // 计算校验和（帧头到内容部分）
     packet[11] = fashion_calculate_checksum(packet, 11);
-    
-    // 使用DMA发送数据
-    HAL_UART_Transmit_DMA(&huart1, packet, 12);
+    return 12;
+}
+
+/**
+ * @brief 发送单圈角度控制指令
+ * @param servo_id 舵机ID (0-7，应答位图为8位按ID逐位跟踪)
+ * @param angle 目标角度（单位：0.1度，例如90.0度 = 900）
+ * @param time_ms 运动时间（单位：毫秒）
+ * @return HAL状态
+ */
+void fashion_send_single_angle(uint8_t servo_id, int16_t angle, uint16_t time_ms)
+{
+    uint8_t packet[FASHION_MAX_PACKET_LENGTH];
+    uint8_t length;
+
+    if (servo_id >= 8)
+    {
+        return;  //应答位图无法跟踪，拒绝指令
+    }
+    length = fashion_build_single_angle(packet, servo_id, angle, time_ms);
+
+    // 登记应答位图后入队，由DMA链式发送
+    fashion_ack_mask = (uint8_t)(1u << servo_id);
+    fashion_enqueue(packet, length);
+}
+
+/**
+ * @brief 计算轨迹流的下一目标位置（来回扫描，边界处折返）
+ * @param pos 当前目标位置
+ * @return 下一目标位置
+ */
+static int16_t fashion_traj_step(int16_t pos)
+{
+    if(traj_dir)
+    {
+        pos += traj_div;
+        if(pos > traj_high)
+        {
+            traj_dir = 0;
+            pos = traj_high - traj_div;
+            if(pos < traj_low)
+            {
+                pos = traj_low;
+            }
+        }
+    }
+    else
+    {
+        pos -= traj_div;
+        if(pos < traj_low)
+        {
+            traj_dir = 1;
+            pos = traj_low + traj_div;
+            if(pos > traj_high)
+            {
+                pos = traj_high;
+            }
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief 启动轨迹流：下发首点并预取下一点
+ * @param pos_low 扫描位置下限（单位：0.1度）
+ * @param pos_high 扫描位置上限（单位：0.1度）
+ * @param pos_div 扫描步距（单位：0.1度）
+ * @param time_ms 单步运动时间（单位：毫秒）
+ * @note 位置序列由下限/上限/步距参数化生成，舵机层自行折返，
+ *       扫描状态机只消费到位事件并在本点工作结束后advance
+ */
+void fashion_traj_start(int16_t pos_low, int16_t pos_high, int16_t pos_div, uint16_t time_ms)
+{
+    traj_low = pos_low;
+    traj_high = pos_high;
+    traj_div = pos_div;
+    traj_time = time_ms;
+    traj_dir = 1;
+    traj_target_pos = pos_low;
+    traj_next_pos = fashion_traj_step(pos_low);
+    traj_next_length = 0;
+    traj_active = 1;
+    fashion_send_single_angle(0, traj_target_pos, traj_time);
+}
+
+/**
+ * @brief 停止轨迹流
+ */
+void fashion_traj_stop(void)
+{
+    traj_active = 0;
+}
+
+/**
+ * @brief 读取轨迹流当前目标位置
+ * @return 当前目标位置（单位：0.1度）
+ */
+int16_t fashion_traj_target(void)
+{
+    return traj_target_pos;
+}
+
+/**
+ * @brief 推进轨迹流：立即下发预构建的下一点指令
+ * @note 在本点的数据采集工作全部完成后调用；报文已在上一次
+ *       到位回包的中断里构建好，此处只做入队，下发零构建延迟
+ */
+void fashion_traj_advance(void)
+{
+    if(traj_active == 0)
+    {
+        return;
+    }
+    if(traj_next_length == 0)
+    {
+        // 到位回包丢失未触发预构建，此处补齐
+        traj_next_length = fashion_build_single_angle(traj_next_packet, 0,
+                                                      traj_next_pos, traj_time);
+    }
+    traj_target_pos = traj_next_pos;
+    traj_next_pos = fashion_traj_step(traj_next_pos);
+    fashion_ack_mask = (uint8_t)(1u << 0);
+    fashion_enqueue(traj_next_packet, traj_next_length);
+    traj_next_length = 0;
+}
+
+/**
+ * @brief 重发轨迹流当前点指令（校验失败后的重试路径）
+ */
+void fashion_traj_resend(void)
+{
+    if(traj_active == 0)
+    {
+        return;
+    }
+    fashion_send_single_angle(0, traj_target_pos, traj_time);
+}
+
+/**
+ * @brief 同步组写多舵机角度：一次总线交易下发全部轴的目标角度
+ * @param servo_ids 舵机ID数组 (各ID 0-7，应答位图为8位按ID逐位跟踪)
+ * @param angles 目标角度数组，与servo_ids一一对应（单位：0.1度）
+ * @param count 舵机数量 (1-FASHION_GROUP_MAX)
+ * @param time_ms 运动时间（单位：毫秒，各轴共用）
+ * @note 各舵机仍各自回角度控制应答，按ID清fashion_ack_mask位，
+ *       位图清空才置flag_fashion完成——轴数增加不增加总线往返次数
+ */
+void fashion_send_group_angle(const uint8_t *servo_ids, const int16_t *angles,
+                              uint8_t count, uint16_t time_ms)
+{
+    uint8_t packet[FASHION_MAX_PACKET_LENGTH];
+    uint8_t offset;
+    uint8_t mask = 0;
+
+    if (count < 1 || count > FASHION_GROUP_MAX)
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (servo_ids[i] >= 8)
+        {
+            return;  //应答位图无法跟踪该ID，整条指令拒绝
+        }
+    }
+    // 构建数据包（帧头+命令ID+长度+舵机数+各[ID+角度]+共用时间）
+    packet[0] = FASHION_FRAME_HEADER_REQ_1;  // 帧头1
+    packet[1] = FASHION_FRAME_HEADER_REQ_2;  // 帧头2
+    packet[2] = FASHION_CMD_SYNC_ANGLE;      // 指令码
+    packet[3] = (uint8_t)(1 + count * 3 + 2); // 内容长度
+    packet[4] = count;                       // 舵机数量
+    offset = 5;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        packet[offset++] = servo_ids[i];                        // 舵机ID
+        packet[offset++] = (uint8_t)(angles[i] & 0xFF);         // 角度低字节
+        packet[offset++] = (uint8_t)((angles[i] >> 8) & 0xFF);  // 角度高字节
+        mask |= (uint8_t)(1u << servo_ids[i]);
+    }
+    // 共用运动时间（小端序，16位）
+    packet[offset++] = (uint8_t)(time_ms & 0xFF);
+    packet[offset++] = (uint8_t)((time_ms >> 8) & 0xFF);
+
+    // 计算校验和（帧头到内容部分）
+    packet[offset] = fashion_calculate_checksum(packet, offset);
+
+    // 登记应答位图后入队，由DMA链式发送
+    fashion_ack_mask = mask;
+    fashion_enqueue(packet, (uint8_t)(offset + 1));
 }
 
 /**
@@ -120,6 +529,7 @@ void fashion_send_single_angle(uint8_t servo_id, int16_t angle, uint16_t time_ms
  */
 void fashion_read_servo_angle(uint8_t servo_id)
 {
+    uint8_t packet[FASHION_MAX_PACKET_LENGTH];
     // 构建数据包（根据协议规范：帧头+命令ID+长度+舵机ID+校验和）
     packet[0] = FASHION_FRAME_HEADER_REQ_1;  // 帧头1 (0x12)
     packet[1] = FASHION_FRAME_HEADER_REQ_2;  // 帧头2 (0x4C)
@@ -130,8 +540,8 @@ void fashion_read_servo_angle(uint8_t servo_id)
     // 计算校验和（帧头到内容部分，共5个字节）
     packet[5] = fashion_calculate_checksum(packet, 5);
     
-    // 使用DMA发送数据（总共6个字节）
-    HAL_UART_Transmit_DMA(&huart1, packet, 6);
+    // 入队，由DMA链式发送（总共6个字节）
+    fashion_enqueue(packet, 6);
 }
 
 /**
@@ -142,6 +552,7 @@ void fashion_read_servo_angle(uint8_t servo_id)
  */
 void fashion_read_data(uint8_t servo_id, uint8_t data_type)
 {
+    uint8_t packet[FASHION_MAX_PACKET_LENGTH];
     // 构建数据包（根据协议规范：帧头+命令ID+长度+舵机ID+数据类型+校验和）
     packet[0] = FASHION_FRAME_HEADER_REQ_1;  // 帧头1 (0x12)
     packet[1] = FASHION_FRAME_HEADER_REQ_2;  // 帧头2 (0x4C)
@@ -153,8 +564,8 @@ void fashion_read_data(uint8_t servo_id, uint8_t data_type)
     // 计算校验和（帧头到内容部分，共6个字节）
     packet[6] = fashion_calculate_checksum(packet, 6);
     
-    // 使用DMA发送数据（总共7个字节）
-    HAL_UART_Transmit_DMA(&huart1, packet, 7);
+    // 入队，由DMA链式发送（总共7个字节）
+    fashion_enqueue(packet, 7);
 }
 
 /**
@@ -165,6 +576,7 @@ void fashion_read_data(uint8_t servo_id, uint8_t data_type)
  */
 void fashion_monitor_data(uint8_t servo_id, uint8_t monitor_type)
 {
+    uint8_t packet[FASHION_MAX_PACKET_LENGTH];
     // 构建数据包（根据协议规范：帧头+命令ID+长度+舵机ID+监控类型+校验和）
     packet[0] = FASHION_FRAME_HEADER_REQ_1;  // 帧头1 (0x12)
     packet[1] = FASHION_FRAME_HEADER_REQ_2;  // 帧头2 (0x4C)
@@ -176,6 +588,6 @@ void fashion_monitor_data(uint8_t servo_id, uint8_t monitor_type)
     // 计算校验和（帧头到内容部分，共6个字节）
     packet[6] = fashion_calculate_checksum(packet, 6);
     
-    // 使用DMA发送数据（总共7个字节）
-    HAL_UART_Transmit_DMA(&huart1, packet, 7);
+    // 入队，由DMA链式发送（总共7个字节）
+    fashion_enqueue(packet, 7);
 }
\ No newline at end of file
@@ -19,20 +19,42 @@ extern "C" {
 #define FASHION_CMD_PING              0x01
 #define FASHION_CMD_DATA_READ         0x03  // 数据读取
 #define FASHION_CMD_SINGLE_ANGLE      0x08
+#define FASHION_CMD_SYNC_ANGLE        0x09  // 多舵机同步角度写入
 #define FASHION_CMD_READ_ANGLE        0x0A
 #define FASHION_CMD_DATA_MONITOR      0x16  // 数据监控
 
+// 监控类型
+#define FASHION_MONITOR_ANGLE         0x00  // 角度监控流
+
 // 最大数据包长度
 #define FASHION_MAX_PACKET_LENGTH     20
 
+// 指令队列深度（必须为2的幂）
+#define FASHION_QUEUE_DEPTH           8
+
+// 同步组写最大舵机数（受报文长度限制）
+#define FASHION_GROUP_MAX             4
+
+extern volatile uint32_t fashion_q_dropped;	//指令队列满丢弃计数
+extern volatile uint32_t fashion_rx_crc_errors;	//舵机回包校验和失败计数
+extern volatile uint8_t fashion_ack_mask;		//在途角度指令的按ID应答位图
+
 // 函数声明
 uint8_t fashion_calculate_checksum(uint8_t *data, uint8_t length);
+void fashion_traj_start(int16_t pos_low, int16_t pos_high, int16_t pos_div, uint16_t time_ms);
+void fashion_traj_stop(void);
+void fashion_traj_advance(void);
+void fashion_traj_resend(void);
+int16_t fashion_traj_target(void);
+void fashion_tx_complete(void);
 void fashion_send_ping(uint8_t servo_id);
 void fashion_send_single_angle(uint8_t servo_id, int16_t angle, uint16_t time_ms);
+void fashion_send_group_angle(const uint8_t *servo_ids, const int16_t *angles,
+                              uint8_t count, uint16_t time_ms);
 void fashion_read_servo_angle(uint8_t servo_id);
 void fashion_read_data(uint8_t servo_id, uint8_t data_type);
 void fashion_monitor_data(uint8_t servo_id, uint8_t monitor_type);
-void fashion_process_response(uint8_t length);
+void fashion_rx_scan(uint16_t dma_head);
 
 #ifdef __cplusplus
 }
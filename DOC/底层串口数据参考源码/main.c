@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "adc.h"
+#include "crc.h"
 #include "dma.h"
 #include "i2c.h"
 #include "sdadc.h"
@@ -29,17 +30,50 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "fashion_driver.h"
+#include "scan_scheduler.h"
+#include "uart_tx_ring.h"
+#include "param_store.h"
+#include "perf_probe.h"
 #include <math.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
+// 连续模式扫描状态机
+typedef enum {
+	CSCAN_HOME_WAIT = 0,	//等待舵机回到posLow
+	CSCAN_LIDAR_SET,			//设置激光器状态
+	CSCAN_LIDAR_WAIT,			//等待激光器启动
+	CSCAN_ANGLE_POLL,			//确认当前处于端点位置
+	CSCAN_SWEEP_START,		//启动舵机扫描并开始上传
+	CSCAN_SWEEP_WAIT,			//等待舵机到达另一端点
+}CScanState;
+
+// 离散模式扫描状态机
+typedef enum {
+	DSCAN_MOVE = 0,				//下发目标位置
+	DSCAN_MOVE_WAIT,			//等待舵机动作完成
+	DSCAN_VERIFY,					//回读角度校验（带重试）
+	DSCAN_SETTLE,					//激光器稳定延时
+	DSCAN_GAIN_WAIT,			//等待自动增益完成后上传
+}DScanState;
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#define CSCAN_MONITOR_TIMEOUT 100	//角度监控流静默超时(ms)，超时退回显式回读
+#define ADJ_MAG_HIGH 28000	//自动增益下调阈值(接近满量程)
+#define ADJ_MAG_LOW 4000		//自动增益上调阈值(信号过弱)
+#define BAUD_MIN 9600				//上行波特率协商下限
+#define BAUD_MAX 2000000		//上行波特率协商上限(USART2时钟源为SYSCLK)
+#define BAUD_CONFIRM_TIMEOUT 1000	//新速率确认超时(ms)，超时自动回退
+#define BAUD_DRAIN_TIMEOUT 200		//旧速率排空超时(ms)，上行饱和时强制切换
+#define STAT_SAT_LEVEL 32700			//幅值统计饱和判定阈值(接近ADC满量程)
+#define TIMEBASE_CPU_MHZ 72				//微秒时基折算：DWT周期计数/主频MHz
+#define STATS_FRAME_SIZE 69				//幅值统计帧长度(帧头2+样本数2+8通道×8+帧尾1)
+#define DSCAN_DARK_SETTLE 1				//暗场/掩码不变时的稳定延时(ms)，无需光学稳定
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -56,7 +90,9 @@
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
-
+static void statAccReset(void);
+static uint32_t timeMicros(void);
+static void autoAdjRun(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -64,12 +100,155 @@ void SystemClock_Config(void);
 ControlParams uartCtrl = {0};
 uint8_t mutex_autoadj = Release;	//自动增益调节过程中的锁
 uint8_t flag_fashion = Release;		//舵机运行完成
-uint8_t data_frame_upload[40] = {0};
+uint8_t data_frame_upload[UPLOAD_BATCH_MAX][UPLOAD_FRAME_SIZE] = {0};	//批量组帧暂存区
+static uint8_t upload_build = 0;		//暂存区中的组帧位置（已积累的完整帧数）
+
+// 上传快照环：TIM4中断只做采样快照，组帧/CRC/发送在主循环低优先级上下文完成，
+// 避免重负载拖长TIM4中断、抖动采样时序
+typedef struct {
+	uint16_t adc[4];		//adc_frame快照
+	int16_t sdadc[8];		//sdadc_frame快照
+	uint8_t adj[8];			//autoadj快照
+	uint16_t master;		//主帧序号
+	uint16_t pos;				//子帧序号
+	uint8_t lidar;			//激光器状态
+	uint8_t decim;			//本帧实际平均的采样数K
+	uint32_t us;				//采样时刻微秒时间戳(SDADC交付时刻锁存)
+}UploadSnap;
+static UploadSnap upload_snap[UPLOAD_SNAP_DEPTH];
+static volatile uint8_t snap_head = 0;	//写位置（中断侧）
+static volatile uint8_t snap_tail = 0;	//读位置（主循环侧）
+volatile uint32_t upload_snap_dropped = 0;	//快照环满丢弃计数
+
+// SDADC连续环形采集：DMA循环写入多帧环，半满/全满回调按块交付，
+// 两个转换器由同一触发节拍驱动，相同序号的帧一一对应合并
+static int16_t sdadc1_ring[SDADC_RING_FRAMES][5];	//SDADC1循环DMA缓冲(5通道)
+static int16_t sdadc3_ring[SDADC_RING_FRAMES][3];	//SDADC3循环DMA缓冲(3通道)
+static int16_t sdadc_ring[SDADC_RING_FRAMES][8];	//合并后的完整8通道帧环
+static uint32_t sdadc_ring_us[SDADC_RING_FRAMES];	//各帧的交付时刻微秒时间戳
+static uint32_t sdadc_frame_us = 0;								//当前sdadc_frame的采样时间戳
+static volatile uint8_t sdadc_ring_head = 0;	//合并帧写位置
+static volatile uint8_t sdadc_ring_tail = 0;	//合并帧读位置(上传侧消费)
+volatile uint32_t sdadc_ring_overrun = 0;			//消费不及覆盖最旧帧计数
+
+// 整程捕获环(dMode)：一程扫描的全部帧先积累在RAM中，程间/程中由主循环
+// 从环尾向发送环搬运——机械驻留节拍与串口带宽解耦。256帧覆盖常用
+// 分辨率下的整程；更长的扫描在捕获环满后退化为边采边发
+static uint8_t sweep_cap[SWEEP_CAP_FRAMES][UPLOAD_FRAME_SIZE];
+static volatile uint16_t sweep_cap_head = 0;	//组帧写位置
+static volatile uint16_t sweep_cap_tail = 0;	//发送搬运位置
+volatile uint32_t sweep_cap_dropped = 0;			//捕获环满丢弃计数
+
+// 自动增益流水线：TIM3节拍评估sdadc各通道幅值并更新挡位，8笔I2C写
+// (4芯片×A/B两路)经事务引擎高优先级队列流水下发，全程不占用CPU等待；
+// 增益建立与舵机运动重叠，dMode驻留不再为增益串行等待
+static const uint8_t adj_sdadc_map[8] = {0,1,2,5,3,4,6,7};	//挡位通道->sdadc_frame下标
+
+// I2C事务引擎：增益写入与调试读写共用同一总线，统一排队由DMA完成
+// 回调链式接力——背靠背事务间总线无空闲，也杜绝了在途DMA被新请求
+// 覆盖导致的静默失败。高优先级队列(增益写)总是先于低优先级(调试
+// 读写)出队，增益更新最多只等一笔在途调试事务完成
+#define IIC_DIR_WRITE	0
+#define IIC_DIR_READ	1
+#define IIC_Q_DEPTH		16	//2的幂；高优先级队列须容纳一整轮8笔增益写
+typedef struct {
+	uint8_t addr;			//I2C从机地址(adjaddr[]值)
+	uint8_t dir;			//IIC_DIR_WRITE/IIC_DIR_READ
+	uint8_t gain;			//增益写标志：完成时递减mutex_autoadj
+	uint8_t data[2];	//写数据(指令字节+挡位)
+}IicTxn;
+static IicTxn iic_q_hi[IIC_Q_DEPTH];		//高优先级队列：增益写
+static IicTxn iic_q_lo[IIC_Q_DEPTH];		//低优先级队列：调试读写
+static volatile uint8_t iic_hi_head = 0, iic_hi_tail = 0;
+static volatile uint8_t iic_lo_head = 0, iic_lo_tail = 0;
+static IicTxn iic_cur;									//在途事务(DMA期间报文常驻于此)
+static volatile uint8_t iic_busy = 0;		//总线在途标志
+static void iicSubmit(uint8_t pri, const IicTxn *txn);
+static void iicKick(void);
+
+// 重传历史窗：保留最近组装的N帧，上位机按(master,pos)序号请求补发。
+// 噪声丢一帧只需重传42字节，免去整程机械重扫
+static uint8_t retx_buf[RETX_FRAMES][UPLOAD_FRAME_SIZE];
+static volatile uint16_t retx_head = 0;	//写位置（只增，min(head,N)为有效深度）
+
+// 流式会话：cMode长时捕获的滑动窗口确认，以重传历史窗为退避存储。
+// 会话期间每帧仍实时发送；每W帧发一个窗口边界标记帧(0xA9 0xBC)携带
+// 累计序号，上位机按标记回发累计确认。未确认帧在历史窗将被覆盖前
+// 由固件主动补发——上位机短暂卡顿(落盘冲刷等)从永久丢帧降级为补发时延
+static uint8_t sess_enable = 0;						//会话开关(会话级，不落FLASH)
+static uint16_t sess_window = 32;					//窗口帧数：每W帧发一个边界标记
+static volatile uint16_t sess_acked = 0;	//上位机已累计确认的记录序号
+static uint16_t sess_since_mark = 0;			//距上个窗口标记的帧数
+static volatile uint32_t sess_resent = 0;	//覆盖前主动补发的帧数
+
+// 片上过采样抽取：连续累加K帧采样后取均值上传，信噪比等效上位机
+// 均值滤波，串口带宽降为1/K
+static uint32_t decim_adc_sum[4];		//adc累加器
+static int32_t decim_sdadc_sum[8];	//sdadc累加器
+static uint16_t decim_count = 0;		//已累加帧数
 uint8_t mask_lidar[4] = {0x00,0x01,0x02,0x03};	//00 01 10 11 ....111 000当前只有两个激光器
 uint8_t index_lidar = 0;			//激光器开启状态
+
+// 掩码扫描顺序优化(dMode)：按格雷序0,1,3,2遍历掩码，相邻掩码仅差
+// 一台激光器；逐位置往返遍历使相邻位置衔接处掩码不变，每位置的
+// 激光器通断从8次(逐掩码全关再开)降到3次。稳定延时按转换结算：
+// 有激光器通断等lidarTime，暗场或掩码未变只等固定短延时
+static const uint8_t mask_scan_order[4] = {0,1,3,2};	//格雷序遍历的mask_lidar下标
+static uint8_t mask_scan_step = 0;	//本位置已采掩码数0..3
+static uint8_t mask_scan_dir = 0;		//0正序 1逆序，逐位置翻转
+static uint8_t mask_applied = 0;		//当前施加在激光器上的掩码
 uint16_t data_frame_master = 0;//主帧序号
 uint16_t data_frame_pos = 0;//子帧序号/位置
 
+// 扫描状态机进入标志：模式位首次命中时做一次初始化，模式退出或modeInit时复位
+static uint8_t dbg_entered = 0;
+static uint8_t cscan_entered = 0;
+static uint8_t dscan_entered = 0;
+static uint8_t bench_entered = 0;
+
+// 链路基准计数：合成帧提交数与发送环实际接收数，差值即链路丢帧
+volatile uint32_t bench_offered = 0;	//提交的合成帧数
+volatile uint32_t bench_sent = 0;			//发送环实际接收帧数
+
+// 运行时波特率协商：旧速率应答->双方切换->新速率收到有效帧确认，
+// 确认超时自动回退旧速率，链路不因一次失败的协商失联
+static volatile uint8_t baud_state = 0;		//0空闲 1应答排空中 2新速率待确认
+static uint32_t baud_pending = 0;					//待切换波特率
+static uint32_t baud_fallback = 0;				//回退用的切换前波特率
+static ScanTimer baud_timer;							//确认超时定时器
+
+// 差分紧凑帧：每N帧发一个完整关键帧(0xA9 0xB5)，其余帧只携带变化位图
+// 和变化字段(0xA9 0xB4)。逐会话由指令协商开启，老上位机不受影响
+static uint8_t delta_enable = 0;					//差分帧开关（会话级，不落FLASH）
+static uint16_t delta_keyint = 16;				//关键帧间隔N
+static uint16_t delta_since_key = 0;			//距上一关键帧的差分帧数
+static UploadSnap delta_ref;							//参考帧：最近一次已发送的字段值
+static uint8_t delta_ref_valid = 0;				//参考帧是否有效（关键帧发出后置位）
+
+// 片上幅值统计：按可配置窗口累计sdadc各通道min/max/均值与饱和样本数，
+// 以低速率诊断帧(0xA9 0xB9)上报——空闲监测时上位机可把上传周期降到
+// 1/10而不丢失包络信息，增益决策与饱和报警不再依赖全速数据流
+typedef struct {
+	int16_t min[8];			//窗口内各通道最小值
+	int16_t max[8];			//窗口内各通道最大值
+	int32_t sum[8];			//窗口内各通道累加(求均值)
+	uint16_t sat[8];		//窗口内饱和样本计数(|v|>=STAT_SAT_LEVEL)
+	uint16_t count;			//窗口内已累计样本数
+}ChanStats;
+// 链路计量计数器：单调递增的32位计数，覆盖产出/送出/各环节丢弃，
+// 现场凭查询一次计数器即可把丢帧定位到固件/线缆/上位机侧
+volatile uint32_t cnt_frames_offered = 0;	//采样快照产出数(含因环满丢弃的)
+volatile uint32_t cnt_frames_sent = 0;		//上行路径实际入发送环的帧数
+volatile uint32_t cnt_servo_retry = 0;		//dMode位置校验失败后的重发次数
+volatile uint32_t cnt_i2c_txn = 0;				//I2C事务引擎启动的事务数
+static uint16_t ctr_period = 0;						//计数器帧自动上报周期(每N帧，0=关闭)
+static uint16_t ctr_since = 0;						//距上次自动上报的帧数
+
+static ChanStats stat_acc;								//累计中的窗口(TIM4中断侧)
+static ChanStats stat_latch;							//已完成待发送的窗口(主循环侧)
+static volatile uint8_t stat_ready = 0;		//latch窗口有效标志
+static uint16_t stat_window = 0;					//统计窗口样本数(0=关闭)
+
 /* USER CODE END 0 */
 
 /**
@@ -80,9 +259,6 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-	data_frame_upload[0] = 0xA9;
-	data_frame_upload[1] = 0xB5;
-	data_frame_upload[39] = 0x33;
 	uartCtrl.flagMask = 0;					//模式控制掩码
 	uartCtrl.posLow=0;
 	uartCtrl.posHigh=1000;
@@ -92,6 +268,14 @@ int main(void)
 	uartCtrl.uartUploadTime=1;
 	uartCtrl.fashionTime=1000;
 	uartCtrl.lidarTime=10;
+	uartCtrl.uploadBatch=1;
+	uartCtrl.decimFactor=1;
+	if(paramStoreRestore()){
+		// FLASH中有有效配置：覆盖上述默认值，并按恢复的周期重算
+		// 定时器重装值，使稍后的定时器初始化直接按恢复配置生效
+		data_arr = 10000 / uartCtrl.uartUploadTime - 1;
+		adj_arr = 10000 / uartCtrl.adjTime - 1;
+	}
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -116,6 +300,7 @@ int main(void)
   MX_USART1_UART_Init();
   MX_USART2_UART_Init();
   MX_I2C1_Init();
+  MX_CRC_Init();
   MX_ADC1_Init();
   MX_SDADC1_Init();
   MX_SDADC3_Init();
@@ -124,14 +309,21 @@ int main(void)
   /* USER CODE BEGIN 2 */
   HAL_UARTEx_ReceiveToIdle_DMA(&huart1,ReceiveBuff1,BUFFERSIZE);
   HAL_UARTEx_ReceiveToIdle_IT(&huart2,recv_frame2,FRAMESIZE);
-	
+	txRingInit();	//上行发送环
+	perfInit();		//使能DWT周期计数，热路径打点常开
+	if(param_store_loaded){
+		modeInit();	//自主恢复上次扫描模式，无需等待上位机重放配置
+	}
+
 	HAL_SDADC_CalibrationStart(&hsdadc1, SDADC_CALIBRATION_SEQ_1);
 	HAL_SDADC_PollForCalibEvent(&hsdadc1, HAL_MAX_DELAY);
 	HAL_SDADC_CalibrationStart(&hsdadc3, SDADC_CALIBRATION_SEQ_1);
 	HAL_SDADC_PollForCalibEvent(&hsdadc3, HAL_MAX_DELAY);
 	
-	HAL_SDADC_InjectedStart_DMA(&hsdadc1,(uint32_t*)sdadc_frame, 5);
-	HAL_SDADC_InjectedStart_DMA(&hsdadc3,(uint32_t*)&sdadc_frame[5], 3);	
+	// 循环DMA连续写入多帧环（CubeMX中两路SDADC的DMA通道配置为Circular），
+	// 半满/全满回调按半区交付完整采样块，转换全程无启停间隙
+	HAL_SDADC_InjectedStart_DMA(&hsdadc1,(uint32_t*)sdadc1_ring, SDADC_RING_FRAMES*5);
+	HAL_SDADC_InjectedStart_DMA(&hsdadc3,(uint32_t*)sdadc3_ring, SDADC_RING_FRAMES*3);
 	
 	HAL_ADC_Start_DMA(&hadc1,(uint32_t*)adc_frame,4);
 	
@@ -143,10 +335,14 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-	  HAL_Delay(500);
+		// 扫描状态机由事件和软件定时器推进，主循环不再阻塞等待
 		debugModeSet();
 		cModeSet();
 		dModeSet();
+		benchModeSet();
+		baudNegotiateProcess();	//波特率切换/回退时序
+		dataUploadProcess();	//低优先级上下文：消费快照环组帧并发送
+		statsUploadProcess();	//幅值统计窗口完成后的低速率诊断帧
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -211,328 +407,1144 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+// 指令处理函数：arg指向指令码之后的参数区(recv_frame2[3])
+// 由串口接收空闲中断上下文直接调用，优先级天然高于主循环扫描状态机，
+// 模式切换/急停类指令(0x07)在一个串口帧时间内生效
+static uint16_t cmdArg16(const uint8_t *arg, uint8_t idx){
+	return (uint16_t)((arg[idx*2]<<8)+arg[idx*2+1]);
+}
+static void cmdRead(const uint8_t *arg){	//读取指令
+	txRingSend((uint8_t *)&uartCtrl,sizeof(uartCtrl));
+}
+static void cmdBatchWrite(const uint8_t *arg){	//批量写入指令
+	memcpy(&uartCtrl,arg,sizeof(uartCtrl));
+}
+static void cmdSetUartFreq(const uint8_t *arg){	//设置串口发送频率
+	uartCtrl.uartUploadTime = cmdArg16(arg,0);
+	data_arr = 10000 / uartCtrl.uartUploadTime - 1;
+	if(HAL_TIM_Base_GetState(&htim4)==HAL_TIM_STATE_BUSY){
+		HAL_TIM_Base_Stop_IT(&htim4); 	//关闭自动上传
+	}
+	MX_TIM4_Init();
+}
+static void cmdSetAdjFreq(const uint8_t *arg){	//设置自动增益频率
+	uartCtrl.adjTime = cmdArg16(arg,0);
+	adj_arr = 10000 / uartCtrl.adjTime - 1;
+	HAL_TIM_Base_Stop_IT(&htim3);
+	MX_TIM3_Init();
+	HAL_TIM_Base_Start_IT(&htim3);
+}
+static void cmdSetServoTime(const uint8_t *arg){	//设置舵机单运转时间
+	uartCtrl.fashionTime = cmdArg16(arg,0);
+}
+static void cmdSetServoPos(const uint8_t *arg){	//设置舵机运转位置参数
+	uartCtrl.posLow = cmdArg16(arg,0);
+	uartCtrl.posHigh = cmdArg16(arg,1);
+	uartCtrl.posDiv = cmdArg16(arg,2);
+	uartCtrl.posSet = cmdArg16(arg,3);
+}
+static void cmdSetWorkMode(const uint8_t *arg){	//设置工作模式
+	uartCtrl.flagMask = cmdArg16(arg,0);
+	modeInit();
+}
+static void cmdSetLidarDelay(const uint8_t *arg){	//设置激光器开启延时
+	uartCtrl.lidarTime = cmdArg16(arg,0);
+}
+static void cmdSetUploadBatch(const uint8_t *arg){	//设置批量上传帧数
+	dataUploadFlush();	//先冲刷按旧批量积累的帧
+	uartCtrl.uploadBatch = cmdArg16(arg,0);
+	if(uartCtrl.uploadBatch < 1){
+		uartCtrl.uploadBatch = 1;
+	}else if(uartCtrl.uploadBatch > UPLOAD_BATCH_MAX){
+		uartCtrl.uploadBatch = UPLOAD_BATCH_MAX;
+	}
+}
+static void cmdSetDecimFactor(const uint8_t *arg){	//设置过采样抽取因子
+	uartCtrl.decimFactor = cmdArg16(arg,0);
+	if(uartCtrl.decimFactor < 1){
+		uartCtrl.decimFactor = 1;
+	}else if(uartCtrl.decimFactor > DECIM_FACTOR_MAX){
+		uartCtrl.decimFactor = DECIM_FACTOR_MAX;
+	}
+}
+static void countersSend(void){	//发送链路计量计数器诊断帧
+	// 0xA9 0xBA | 计数器数量 | 各计数器4字节(小端) | 0x33
+	// 指令中断与主循环定期上报都会进来，栈上组帧避免共享缓冲被打断撕裂
+	uint8_t diag[4 + 10*4];
+	const volatile uint32_t *counters[10] = {
+		&cnt_frames_offered, &cnt_frames_sent, &txring_dropped,
+		&upload_snap_dropped, &sdadc_ring_overrun, &sweep_cap_dropped,
+		&fashion_q_dropped, &fashion_rx_crc_errors, &cnt_servo_retry,
+		&cnt_i2c_txn,
+	};
+	uint8_t *p = diag;
+	*p++ = 0xA9;
+	*p++ = 0xBA;
+	*p++ = 10;
+	for(uint8_t i = 0; i < 10; i++){
+		uint32_t v = *counters[i];
+		memcpy(p,&v,4);
+		p += 4;
+	}
+	*p = 0x33;
+	txRingSend(diag,sizeof(diag));
+}
+static void cmdReadTimebase(const uint8_t *arg){	//采样微秒时基读数(钟差估计)
+	// 0xA9 0xBB | 微秒时基4字节(小端) | 0x33
+	static uint8_t diag[7];
+	uint32_t us = timeMicros();
+	diag[0] = 0xA9;
+	diag[1] = 0xBB;
+	memcpy(&diag[2],&us,4);
+	diag[6] = 0x33;
+	txRingSend(diag,sizeof(diag));
+}
+static void cmdReadCounters(const uint8_t *arg){	//查询计数器[自动上报周期N帧,0=关闭]
+	ctr_period = cmdArg16(arg,0);
+	ctr_since = 0;
+	countersSend();	//立即回一帧当前值
+}
+static void cmdSetStatsWindow(const uint8_t *arg){	//设置幅值统计窗口样本数(0=关闭)
+	stat_window = cmdArg16(arg,0);
+	stat_ready = 0;	//丢弃旧窗口，按新窗口重新累计
+	statAccReset();
+}
+static void cmdSetDeltaMode(const uint8_t *arg){	//设置差分紧凑帧模式[开关 关键帧间隔]
+	dataUploadFlush();	//冲刷按旧格式积累的帧，切换点前后帧序一致
+	delta_enable = (cmdArg16(arg,0) != 0);
+	delta_keyint = cmdArg16(arg,1);
+	if(delta_keyint < 1){
+		delta_keyint = 1;
+	}
+	delta_ref_valid = 0;	//重新从关键帧开始
+	delta_since_key = 0;
+}
+static void cmdCommitParams(const uint8_t *arg){	//提交当前参数到FLASH
+	if(paramStoreSave()){
+		txRingSend((uint8_t *)&uartCtrl,sizeof(uartCtrl));	//应答：回读已固化参数
+	}
+}
+static void cmdResendFrame(const uint8_t *arg){	//按(master,pos)序号重传历史帧
+	uint16_t master = cmdArg16(arg,0);
+	uint16_t pos = cmdArg16(arg,1);
+	uint16_t depth = (retx_head < RETX_FRAMES) ? retx_head : RETX_FRAMES;
+	for(uint16_t i = 0; i < depth; i++){
+		// 从最新帧向旧回溯，帧内序号为小端
+		uint8_t *frame = retx_buf[(uint16_t)(retx_head - 1 - i) & (RETX_FRAMES-1)];
+		uint16_t fmaster = (uint16_t)(frame[34] | (frame[35]<<8));
+		uint16_t fpos = (uint16_t)(frame[36] | (frame[37]<<8));
+		if(fmaster == master && fpos == pos){
+			txRingSend(frame,UPLOAD_FRAME_SIZE);
+			return;
+		}
+	}
+	// 历史窗内未命中则静默，上位机按超时放弃
+}
+static void sessMarkSend(void){	//发送流式会话窗口边界标记帧
+	// 0xA9 0xBC | 累计记录序号(2字节小端) | 累计补发帧数(4字节小端) | 0x33
+	// 会话指令中断与主循环逐窗上报都会进来，栈上组帧避免共享缓冲被打断撕裂
+	uint8_t mark[9];
+	uint32_t resent = sess_resent;
+	mark[0] = 0xA9;
+	mark[1] = 0xBC;
+	memcpy(&mark[2],(const void *)&retx_head,2);
+	memcpy(&mark[4],&resent,4);
+	mark[8] = 0x33;
+	txRingSend(mark,sizeof(mark));
+}
+static void cmdStreamSession(const uint8_t *arg){	//开启/关闭流式会话
+	sess_enable = (cmdArg16(arg,0) != 0);
+	sess_window = cmdArg16(arg,1);
+	if(sess_window < 1){
+		sess_window = 1;
+	}
+	sess_acked = retx_head;	//开启时以当前记录序号为基准，旧帧视为已确认
+	sess_since_mark = 0;
+	sess_resent = 0;
+	if(sess_enable){
+		sessMarkSend();	//立即下发基准序号，上位机由此对齐确认计数
+	}
+}
+static void cmdStreamAck(const uint8_t *arg){	//流式会话累计确认
+	sess_acked = cmdArg16(arg,0);
+}
+static void cmdReadPerfStats(const uint8_t *arg){	//读取性能统计诊断帧
+	// 诊断帧：0xA9 0xB6 | 探针数 | 每探针min/max/mean/count各4字节(小端) | 0x33
+	static uint8_t diag[4 + PERF_PROBE_COUNT*16];
+	uint8_t *p = diag;
+	*p++ = 0xA9;
+	*p++ = 0xB6;
+	*p++ = PERF_PROBE_COUNT;
+	for(uint8_t i = 0; i < PERF_PROBE_COUNT; i++){
+		PerfStat *s = &perf_stats[i];
+		uint32_t minv = (s->count != 0) ? s->min : 0;
+		uint32_t mean = (s->count != 0) ? (s->sum / s->count) : 0;
+		memcpy(p,&minv,4); p += 4;
+		memcpy(p,&s->max,4); p += 4;
+		memcpy(p,&mean,4); p += 4;
+		memcpy(p,&s->count,4); p += 4;
+	}
+	*p = 0x33;
+	txRingSend(diag,sizeof(diag));
+	if(arg[0] == 0x01){
+		perfReset();	//按需清零，便于窗口化观测
+	}
+}
+static void cmdSetBaud(const uint8_t *arg){	//协商上行波特率
+	uint32_t baud = ((uint32_t)cmdArg16(arg,0) << 16) | cmdArg16(arg,1);
+	static uint8_t ack[7];
+	if(baud < BAUD_MIN || baud > BAUD_MAX){
+		return;	//越界提案静默忽略，链路保持现速率
+	}
+	// 应答在当前(旧)速率发出：0xA9 0xB8 | 波特率(4字节小端) | 0x33
+	ack[0] = 0xA9;
+	ack[1] = 0xB8;
+	memcpy(&ack[2],&baud,4);
+	ack[6] = 0x33;
+	txRingSend(ack,sizeof(ack));
+	if(baud == huart2.Init.BaudRate){
+		return;	//同速率提案只作保活应答
+	}
+	baud_fallback = huart2.Init.BaudRate;
+	baud_pending = baud;
+	scanTimerStart(&baud_timer, BAUD_DRAIN_TIMEOUT);	//排空也要有限期，饱和链路不许诺而不切
+	baud_state = 1;	//等待应答随发送环排空后再切换
+}
+static void cmdReadBenchStats(const uint8_t *arg){	//读取链路基准计数
+	// 0xA9 0xB7 | 提交帧数(4字节小端) | 实发帧数(4字节小端) | 0x33
+	static uint8_t stats[11];
+	stats[0] = 0xA9;
+	stats[1] = 0xB7;
+	memcpy(&stats[2],(const void *)&bench_offered,4);
+	memcpy(&stats[6],(const void *)&bench_sent,4);
+	stats[10] = 0x33;
+	txRingSend(stats,sizeof(stats));
+}
+static void cmdIicRead(const uint8_t *arg){	//调试IIC读命令
+	IicTxn txn = {adjaddr[arg[0]],IIC_DIR_READ,0,{0,0}};
+	iicSubmit(0,&txn);
+}
+static void cmdIicWrite(const uint8_t *arg){	//调试IIC写命令
+	IicTxn txn = {adjaddr[arg[0]],IIC_DIR_WRITE,0,{arg[1],arg[2]}};
+	iicSubmit(0,&txn);
+}
+static void cmdServoPing(const uint8_t *arg){	//调试舵机是否在线
+	fashion_send_ping(arg[0]);
+}
+static void cmdServoSetAngle(const uint8_t *arg){	//调试设置舵机角度
+	int16_t ang;
+	uint16_t tim;
+	memcpy(&ang,&arg[1],sizeof(ang));
+	memcpy(&tim,&arg[3],sizeof(tim));
+	fashion_send_single_angle(arg[0],ang,tim);
+}
+static void cmdServoReadAngle(const uint8_t *arg){	//调试读取舵机角度
+	fashion_read_servo_angle(arg[0]);
+}
+static void cmdServoReadData(const uint8_t *arg){	//调试读取数据
+	fashion_read_data(arg[0],arg[1]);
+}
+static void cmdServoMonitor(const uint8_t *arg){	//调试监控数据
+	fashion_monitor_data(arg[0],arg[1]);
+}
+static void cmdStartDebug(const uint8_t *arg){	//带参数启动debug
+	//需要参数posSet、fashiontime、
+	uartCtrl.flagMask = cmdArg16(arg,0);
+	uartCtrl.posSet = cmdArg16(arg,1);
+	uartCtrl.fashionTime = cmdArg16(arg,2);
+	modeInit();
+}
+static void cmdStartCMode(const uint8_t *arg){	//带参数启动cMode
+	//需要参数posLow、posHigh、fashiontime、lidartime
+	uartCtrl.flagMask = cmdArg16(arg,0);
+	uartCtrl.posLow = cmdArg16(arg,1);
+	uartCtrl.posHigh = cmdArg16(arg,2);
+	uartCtrl.fashionTime = cmdArg16(arg,3);
+	uartCtrl.lidarTime = cmdArg16(arg,4);
+	modeInit();
+}
+static void cmdStartDMode(const uint8_t *arg){	//带参数启动dMode
+
+}
+static void cmdBatch(const uint8_t *arg);	//批量执行指令，定义在分发表之后
+
+// 指令分发表：取代原20余项switch，新增指令只需追加表项；
+// 参数区长度供批量指令逐条步进使用
+typedef struct {
+	uint8_t code;												//指令码
+	uint8_t arglen;											//参数区长度
+	void (*handler)(const uint8_t *arg);	//处理函数
+}CmdEntry;
+static const CmdEntry cmd_table[] = {
+	{0x01,0,cmdRead},
+	{0x02,22,cmdBatchWrite},
+	{0x03,2,cmdSetUartFreq},
+	{0x04,2,cmdSetAdjFreq},
+	{0x05,2,cmdSetServoTime},
+	{0x06,8,cmdSetServoPos},
+	{0x07,2,cmdSetWorkMode},
+	{0x08,2,cmdSetLidarDelay},
+	{0x09,2,cmdSetUploadBatch},
+	{0x0A,2,cmdSetDecimFactor},
+	{0x0B,0,cmdCommitParams},
+	{0x0C,4,cmdResendFrame},
+	{0x0D,1,cmdReadPerfStats},
+	{0x0E,0,cmdReadBenchStats},
+	{0x0F,4,cmdSetBaud},
+	{0x10,4,cmdSetDeltaMode},
+	{0x11,1,cmdIicRead},
+	{0x12,3,cmdIicWrite},
+	{0x13,1,cmdServoPing},
+	{0x14,5,cmdServoSetAngle},
+	{0x15,1,cmdServoReadAngle},
+	{0x16,2,cmdServoReadData},
+	{0x17,2,cmdServoMonitor},
+	{0x18,2,cmdSetStatsWindow},
+	{0x19,2,cmdReadCounters},
+	{0x1A,0,cmdReadTimebase},
+	{0x21,6,cmdStartDebug},
+	{0x22,10,cmdStartCMode},
+	{0x23,0,cmdStartDMode},
+	{0x30,0,cmdBatch},
+	{0x31,4,cmdStreamSession},
+	{0x32,2,cmdStreamAck},
+      //后续添加其他指令
+};
+
+/**
+  * @brief 批量执行指令(0x30)：一帧内按序执行多条子指令
+  * @param arg arg[0]为子指令条数，随后按[指令码][参数区]连续排列
+  * @note 每条子指令走常规处理函数，定时器重配/modeInit等副作用完整保留；
+  *       执行完毕统一回读参数作为单次应答，省去逐条往返的主机收发间隔
+  */
+static void cmdBatch(const uint8_t *arg){
+	uint8_t count = arg[0];
+	const uint8_t *p = &arg[1];
+	for(uint8_t n = 0; n < count && p < &recv_frame2[FRAMESIZE]; n++){
+		const CmdEntry *entry = 0;
+		for(uint8_t i = 0; i < sizeof(cmd_table)/sizeof(cmd_table[0]); i++){
+			if(cmd_table[i].code == p[0]){
+				entry = &cmd_table[i];
+				break;
+			}
+		}
+		if(entry == 0 || entry->handler == cmdBatch){
+			break;	//未知子指令或嵌套批量，终止本帧剩余部分
+		}
+		if(p + 1 + entry->arglen > &recv_frame2[FRAMESIZE]){
+			break;	//参数区越过帧缓冲末尾，处理函数会读到越界数据，终止
+		}
+		entry->handler(&p[1]);
+		p += 1 + entry->arglen;
+	}
+	txRingSend((uint8_t *)&uartCtrl,sizeof(uartCtrl));	//单次应答：回读最终参数
+}
+
 void setCtrlParams(void){
+	// 接收空闲中断上下文入口：校验帧头后查表分发，未知指令码静默忽略
 	if(recv_frame2[0]==0xA0&&recv_frame2[1]==0xB3){
-		static uint8_t iicdata[2];
-		static uint8_t cmd_id;
-		int16_t ang;
-		uint16_t tim;
-		switch(recv_frame2[2]){
-			case 0x01:	//读取指令
-				HAL_UART_Transmit_IT(&huart2,(uint8_t *)&uartCtrl,sizeof(uartCtrl));
-				break;
-			case 0x02:	//批量写入指令
-				memcpy(&uartCtrl,recv_frame2+3,sizeof(uartCtrl));
-				break;
-			case 0x03:  //设置串口发送频率
-				uartCtrl.uartUploadTime = (recv_frame2[3]<<8)+recv_frame2[4];
-				data_arr = 10000 / uartCtrl.uartUploadTime - 1;
-				if(HAL_TIM_Base_GetState(&htim4)==HAL_TIM_STATE_BUSY){
-					HAL_TIM_Base_Stop_IT(&htim4); 	//关闭自动上传
-				}
-				MX_TIM4_Init();
-				break;
-			case 0x04:  //设置自动增益频率
-				uartCtrl.adjTime = (recv_frame2[3]<<8)+recv_frame2[4];
-				adj_arr = 10000 / uartCtrl.adjTime - 1;
-				HAL_TIM_Base_Stop_IT(&htim3);
-				MX_TIM3_Init();
-				HAL_TIM_Base_Start_IT(&htim3);
-				break;
-			case 0x05:	//设置舵机单运转时间
-				uartCtrl.fashionTime = (recv_frame2[3]<<8)+recv_frame2[4];
-				break;
-			case 0x06:	//设置舵机运转位置参数
-				uartCtrl.posLow = (recv_frame2[3]<<8)+recv_frame2[4];
-				uartCtrl.posHigh = (recv_frame2[5]<<8)+recv_frame2[6];
-				uartCtrl.posDiv = (recv_frame2[7]<<8)+recv_frame2[8];
-				uartCtrl.posSet = (recv_frame2[9]<<8)+recv_frame2[10];
-				break;
-			case 0x07:	//设置工作模式
-				uartCtrl.flagMask = (recv_frame2[3]<<8)+recv_frame2[4];
-				modeInit();
-				break;			
-			case 0x08:	//设置激光器开启延时
-				uartCtrl.lidarTime = (recv_frame2[3]<<8)+recv_frame2[4];
-				break;
-			case 0x11:	//调试IIC读命令
-				HAL_I2C_Master_Receive_DMA(&hi2c1,adjaddr[recv_frame2[3]],&readadj,1);
-				break;			
-			case 0x12:	//调试IIC写命令
-				iicdata[0] = recv_frame2[4];
-				iicdata[1] = recv_frame2[5];
-				HAL_I2C_Master_Transmit_DMA(&hi2c1,adjaddr[recv_frame2[3]],iicdata,2);
-				break;
-			case 0x13:	//调试舵机是否在线
-				fashion_send_ping(recv_frame2[3]);
-				break;
-			case 0x14:	//调试设置舵机角度
-				memcpy(&ang,&recv_frame2[4],sizeof(ang));
-				memcpy(&tim,&recv_frame2[6],sizeof(tim));
-				fashion_send_single_angle(recv_frame2[3],ang,tim);
-				break;
-			case 0x15:	//调试读取舵机角度
-				fashion_read_servo_angle(recv_frame2[3]);
-				break;
-			case 0x16:	//调试读取数据
-				cmd_id = recv_frame2[4];
-				fashion_read_data(recv_frame2[3],cmd_id);
-				break;
-			case 0x17:	//调试监控数据
-				cmd_id = recv_frame2[4];
-				fashion_monitor_data(recv_frame2[3],cmd_id);
-				break;			
-			case 0x21:	//带参数启动debug
-				//需要参数posSet、fashiontime、
-				uartCtrl.flagMask = (recv_frame2[3]<<8)+recv_frame2[4];
-				uartCtrl.posSet = (recv_frame2[5]<<8)+recv_frame2[6];
-				uartCtrl.fashionTime = (recv_frame2[7]<<8)+recv_frame2[8];
-				modeInit();
-				break;			
-			case 0x22:	//带参数启动cMode
-				//需要参数posLow、posHigh、fashiontime、lidartime
-				uartCtrl.flagMask = (recv_frame2[3]<<8)+recv_frame2[4];
-				uartCtrl.posLow = (recv_frame2[5]<<8)+recv_frame2[6];
-				uartCtrl.posHigh = (recv_frame2[7]<<8)+recv_frame2[8];
-				uartCtrl.fashionTime = (recv_frame2[9]<<8)+recv_frame2[10];
-				uartCtrl.lidarTime = (recv_frame2[11]<<8)+recv_frame2[12];
-				modeInit();
-				break;			
-			case 0x23:	//带参数启动dMode
-				
-				break;
-      //后续添加其他指令
-			default:
+		uint32_t t0 = perfNow();
+		if(baud_state == 2){
+			baud_state = 0;	//新速率下收到有效指令帧，协商确认成功
+		}
+		for(uint8_t i = 0; i < sizeof(cmd_table)/sizeof(cmd_table[0]); i++){
+			if(cmd_table[i].code == recv_frame2[2]){
+				cmd_table[i].handler(&recv_frame2[3]);
 				break;
+			}
 		}
+		perfRecord(PERF_CMD_DISPATCH, t0);
 	}
 	memset(recv_frame2,0,FRAMESIZE);
 }
 
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim){
 	if(htim == &htim3) {
-			// 自动增益调节逻辑
+			// 自动增益调节：工作模式下按adjTime节拍推进流水线，
+			// 增益建立与舵机运动/激光器启动重叠进行
+			if(uartCtrl.flagMask != 0){
+				autoAdjRun();
+			}
 	}
 	else if(htim == &htim4){
+		uint32_t t0 = perfNow();
 		++data_frame_pos;
-		dataUpload();
+		dataUploadSnap();	//仅快照，组帧发送由主循环dataUploadProcess完成
+		perfRecord(PERF_TIM4_ISR, t0);
+	}
+}
+/**
+  * @brief 将SDADC1/SDADC3对应序号的半区帧合并入8通道帧环
+  * @param first 半区起始帧序号(0或SDADC_RING_FRAMES/2)
+  * @note SDADC1注入序列5通道长于SDADC3的3通道，SDADC1半区完成时
+  *       SDADC3同序号帧必已写入，按相同下标合并即为同拍采样
+  */
+static void sdadcCommit(uint8_t first){
+	uint32_t now = timeMicros();	//半区交付时刻锁存，供帧内时间戳
+	for(uint8_t i = first; i < first + SDADC_RING_FRAMES/2; i++){
+		if((uint8_t)(sdadc_ring_head - sdadc_ring_tail) >= SDADC_RING_FRAMES){
+			++sdadc_ring_overrun;	//消费不及，覆盖最旧帧保持数据新鲜
+			++sdadc_ring_tail;
+		}
+		int16_t *dst = sdadc_ring[sdadc_ring_head & (SDADC_RING_FRAMES-1)];
+		memcpy(dst,sdadc1_ring[i],sizeof(sdadc1_ring[i]));
+		memcpy(&dst[5],sdadc3_ring[i],sizeof(sdadc3_ring[i]));
+		sdadc_ring_us[sdadc_ring_head & (SDADC_RING_FRAMES-1)] = now;
+		++sdadc_ring_head;
+	}
+}
+
+/**
+  * @brief 自由运行微秒时基读数
+  * @note 由DWT周期计数折算；32位计数在72MHz下约59.6秒回绕一次，
+  *       上位机按相同模数(2^32/72)展开并配合0x1A指令估计钟差
+  */
+static uint32_t timeMicros(void){
+	return DWT->CYCCNT / TIMEBASE_CPU_MHZ;
+}
+void HAL_SDADC_InjectedConvHalfCpltCallback(SDADC_HandleTypeDef *hsdadc){
+	if(hsdadc == &hsdadc1){
+		sdadcCommit(0);	//前半区采满
+	}
+}
+void HAL_SDADC_InjectedConvCpltCallback(SDADC_HandleTypeDef *hsdadc){
+	if(hsdadc == &hsdadc1){
+		sdadcCommit(SDADC_RING_FRAMES/2);	//后半区采满，DMA回绕继续写前半区
+	}
+}
+/**
+  * @brief 启动下一笔排队的I2C事务
+  * @note 高优先级队列先于低优先级出队；总线在途或两队皆空则直接
+  *       返回。启动失败的事务按完成计并继续尝试下一笔，引擎不因
+  *       单笔失败卡死。须在临界区内或完成回调中调用
+  */
+static void iicKick(void){
+	while(iic_busy == 0){
+		if(iic_hi_tail != iic_hi_head){
+			iic_cur = iic_q_hi[iic_hi_tail & (IIC_Q_DEPTH-1)];
+			++iic_hi_tail;
+		}else if(iic_lo_tail != iic_lo_head){
+			iic_cur = iic_q_lo[iic_lo_tail & (IIC_Q_DEPTH-1)];
+			++iic_lo_tail;
+		}else{
+			return;
+		}
+		++cnt_i2c_txn;
+		iic_busy = 1;
+		if(iic_cur.dir == IIC_DIR_READ){
+			if(HAL_I2C_Master_Receive_DMA(&hi2c1,iic_cur.addr,&readadj,1) == HAL_OK){
+				return;
+			}
+		}else{
+			if(HAL_I2C_Master_Transmit_DMA(&hi2c1,iic_cur.addr,iic_cur.data,2) == HAL_OK){
+				return;
+			}
+		}
+		iic_busy = 0;
+		if(iic_cur.gain && mutex_autoadj != 0){
+			--mutex_autoadj;
+		}
 	}
 }
+
+/**
+  * @brief 提交一笔I2C事务
+  * @note 主循环与中断侧均可调用；总线空闲时就地启动。低优先级队列
+  *       满时静默丢弃(仅调试路径)；高优先级深度足够容纳一整轮增益
+  *       写，且autoAdjRun仅在上一轮锁释放后提交，不会溢出
+  */
+static void iicSubmit(uint8_t pri, const IicTxn *txn){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(pri){
+		if((uint8_t)(iic_hi_head - iic_hi_tail) < IIC_Q_DEPTH){
+			iic_q_hi[iic_hi_head & (IIC_Q_DEPTH-1)] = *txn;
+			++iic_hi_head;
+		}
+	}else{
+		if((uint8_t)(iic_lo_head - iic_lo_tail) < IIC_Q_DEPTH){
+			iic_q_lo[iic_lo_head & (IIC_Q_DEPTH-1)] = *txn;
+			++iic_lo_head;
+		}
+	}
+	iicKick();
+	if(primask == 0){
+		__enable_irq();
+	}
+}
+
+/**
+  * @brief 自动增益调节一轮：评估各通道幅值并提交8笔高优先级增益写入
+  * @note TIM3中断节拍调用；上一轮在途则跳过本拍。接近满量程降一挡、
+  *       信号过弱升一挡，逐拍逼近避免增益振荡。通道0..3写各芯片A路
+  *       (指令字节0x00)，4..7写B路(0x80)，芯片序号=通道号低2位
+  */
+static void autoAdjRun(void){
+	if(mutex_autoadj != 0){
+		return;	//上一轮写入仍在途
+	}
+	mutex_autoadj = 8;	//8笔写全部完成后锁才释放
+	for(uint8_t ch = 0; ch < 8; ch++){
+		int16_t v = sdadc_frame[adj_sdadc_map[ch]];
+		uint16_t mag = (v < 0) ? (uint16_t)(-v) : (uint16_t)v;
+		if(mag > ADJ_MAG_HIGH && autoadj[ch] > 0){
+			--autoadj[ch];
+		}else if(mag < ADJ_MAG_LOW && autoadj[ch] < 255){
+			++autoadj[ch];
+		}
+		IicTxn txn;
+		txn.addr = adjaddr[ch & 0x03];
+		txn.dir = IIC_DIR_WRITE;
+		txn.gain = 1;
+		txn.data[0] = (ch < 4) ? 0x00 : 0x80;	//A/B路选择指令字节
+		txn.data[1] = autoadj[ch];
+		iicSubmit(1,&txn);
+	}
+}
+
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c){
-	--mutex_autoadj;	//调节完成后释放锁
+	if(iic_cur.gain && mutex_autoadj != 0){
+		--mutex_autoadj;	//本笔增益写完成
+	}
+	iic_busy = 0;
+	iicKick();	//链式接力下一笔，总线无空闲
 }
 void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c){
-	HAL_UART_Transmit_IT(&huart2,&readadj,sizeof(readadj));
+	txRingSend(&readadj,sizeof(readadj));
+	iic_busy = 0;
+	iicKick();
+}
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c){
+	// 事务失败(NACK/总线错误)：按完成处理并接力，锁不因单笔失败悬死
+	if(iic_cur.gain && mutex_autoadj != 0){
+		--mutex_autoadj;
+	}
+	iic_busy = 0;
+	iicKick();
 }
 
-void dataUpload(void){
-			// 数据帧逻辑
-		memset(&data_frame_upload[2],0,37); //清空数据位
+/**
+  * @brief 复位幅值统计累计窗口
+  */
+static void statAccReset(void){
+		for(uint8_t i = 0; i < 8; i++){
+			stat_acc.min[i] = 32767;
+			stat_acc.max[i] = -32768;
+			stat_acc.sum[i] = 0;
+			stat_acc.sat[i] = 0;
+		}
+		stat_acc.count = 0;
+}
+
+void dataUploadSnap(void){
+		// 中断侧：仅快照采样值和帧序号，重负载交给主循环
+		// 从采集帧环尾部消费最旧的未取帧，每帧只交付一次；
+		// 环空时沿用上一帧sdadc_frame（与原单缓冲行为一致）。
+		// SDADC交付中断在覆盖最旧帧时也会动tail，消费需临界区保护
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		if(sdadc_ring_tail != sdadc_ring_head){
+			memcpy(sdadc_frame,sdadc_ring[sdadc_ring_tail & (SDADC_RING_FRAMES-1)],sizeof(sdadc_frame));
+			sdadc_frame_us = sdadc_ring_us[sdadc_ring_tail & (SDADC_RING_FRAMES-1)];
+			++sdadc_ring_tail;
+		}
+		if(primask == 0){
+			__enable_irq();
+		}
+		// 幅值统计：按原始采样节拍累计，包络信息不受抽取因子影响
+		if(stat_window != 0){
+			for(uint8_t i = 0; i < 8; i++){
+				int16_t v = sdadc_frame[i];
+				uint16_t mag = (v < 0) ? (uint16_t)(-v) : (uint16_t)v;
+				if(v < stat_acc.min[i]){
+					stat_acc.min[i] = v;
+				}
+				if(v > stat_acc.max[i]){
+					stat_acc.max[i] = v;
+				}
+				stat_acc.sum[i] += v;
+				if(mag >= STAT_SAT_LEVEL){
+					++stat_acc.sat[i];
+				}
+			}
+			++stat_acc.count;
+			if(stat_acc.count >= stat_window){
+				if(stat_ready == 0){
+					stat_latch = stat_acc;	//主循环组帧发送；上一窗未取走则丢弃本窗
+					stat_ready = 1;
+				}
+				statAccReset();
+			}
+		}
+		// 过采样抽取：先累满K帧再产出一个均值快照，上传帧率随之降为1/K。
+		// dMode每次快照对应不同激光器掩码/位置，跨次平均无物理意义，
+		// 抽取旁路为逐帧直出（帧内抽取因子如实标1）
+		uint16_t factor = ((uartCtrl.flagMask & DMode) != 0) ? 1 : uartCtrl.decimFactor;
+		for(uint8_t i = 0; i < 4; i++){
+			decim_adc_sum[i] += adc_frame[i];
+		}
+		for(uint8_t i = 0; i < 8; i++){
+			decim_sdadc_sum[i] += sdadc_frame[i];
+		}
+		++decim_count;
+		if(decim_count < factor){
+			return;
+		}
+		++cnt_frames_offered;
+		if((uint8_t)(snap_head - snap_tail) >= UPLOAD_SNAP_DEPTH){
+			++upload_snap_dropped;	//快照环满，放弃本帧
+		}
+		else{
+			UploadSnap *snap = &upload_snap[snap_head & (UPLOAD_SNAP_DEPTH-1)];
+			for(uint8_t i = 0; i < 4; i++){
+				snap->adc[i] = (uint16_t)(decim_adc_sum[i] / decim_count);
+			}
+			for(uint8_t i = 0; i < 8; i++){
+				snap->sdadc[i] = (int16_t)(decim_sdadc_sum[i] / decim_count);
+			}
+			memcpy(snap->adj,autoadj,sizeof(snap->adj));
+			snap->master = data_frame_master;
+			snap->pos = data_frame_pos;
+			// bit7向上位机标记本机为FLASH配置自主启动，低位仍为激光器掩码索引
+			snap->lidar = index_lidar | (param_store_loaded ? 0x80 : 0x00);
+			snap->decim = (uint8_t)decim_count;	//标记实际平均帧数供上位机换算
+			snap->us = sdadc_frame_us;	//末次累加采样的SDADC交付时刻
+			++snap_head;
+		}
+		memset(decim_adc_sum,0,sizeof(decim_adc_sum));
+		memset(decim_sdadc_sum,0,sizeof(decim_sdadc_sum));
+		decim_count = 0;
+}
+
+/**
+  * @brief 按上传帧布局组装一帧（含帧头、CRC与帧尾）
+  */
+static void uploadBuildFrame(uint8_t *frame, const UploadSnap *snap){
 		//0-1 		帧头0xA9 0xB5						1*2
 		//2-9 		4ch adc 								4*2
 		//10-25 	8ch sdadc 							8*2
 		//26-33		8ch autoadj 						8*1
 		//34-37		2ch frame(master/slave)	2*2
 		//38			1ch lidar state					1*1
-		//39			帧尾0x33								1*1
-		memcpy(&data_frame_upload[2],adc_frame,sizeof(adc_frame));	//adc 4*2 = 8Bytes
-		memcpy(&data_frame_upload[10],sdadc_frame,sizeof(sdadc_frame));//sdadc 8*2 = 16Bytes
-		memcpy(&data_frame_upload[26],autoadj,sizeof(autoadj));//autoadj 8*1 = 8Bytes
-		memcpy(&data_frame_upload[34],&data_frame_master,sizeof(data_frame_master));//2Bytes
-		memcpy(&data_frame_upload[36],&data_frame_pos,sizeof(data_frame_pos));//2Bytes
-		data_frame_upload[38]=index_lidar;//1Bytes
-		// 增益、帧序号
-		HAL_UART_Transmit_IT(&huart2,data_frame_upload,sizeof(data_frame_upload));
+		//39			抽取因子K								1*1
+		//40-43		采样微秒时间戳					1*4
+		//44			CRC8(字节2..43)					1*1
+		//45			帧尾0x33								1*1
+		frame[0]=0xA9;
+		frame[1]=0xB5;
+		memcpy(&frame[2],snap->adc,sizeof(snap->adc));	//adc 4*2 = 8Bytes
+		memcpy(&frame[10],snap->sdadc,sizeof(snap->sdadc));//sdadc 8*2 = 16Bytes
+		memcpy(&frame[26],snap->adj,sizeof(snap->adj));//autoadj 8*1 = 8Bytes
+		memcpy(&frame[34],&snap->master,sizeof(snap->master));//2Bytes
+		memcpy(&frame[36],&snap->pos,sizeof(snap->pos));//2Bytes
+		frame[38]=snap->lidar;//1Bytes
+		frame[39]=snap->decim;//1Bytes，上位机据此换算有效采样率
+		memcpy(&frame[40],&snap->us,sizeof(snap->us));//4Bytes，SDADC交付时刻锁存的真实采样时间
+		// 硬件CRC：CRC-8 多项式0x07 初值0xFF，覆盖字节2..43（CubeMX按8位输入配置CRC外设）
+		frame[44]=(uint8_t)HAL_CRC_Calculate(&hcrc,(uint32_t*)&frame[2],42);
+		frame[45]=0x33;
+		// 记入重传历史窗，供上位机按序号请求补发
+		if(sess_enable && (uint16_t)(retx_head - sess_acked) >= RETX_FRAMES){
+			// 最旧的未确认帧将被覆盖：先主动补发一次再让位，
+			// 上位机卡顿期间的数据以补发时延为代价保留
+			if(txRingSend(retx_buf[retx_head & (RETX_FRAMES-1)],UPLOAD_FRAME_SIZE)){
+				++sess_resent;
+			}
+		}
+		memcpy(retx_buf[retx_head & (RETX_FRAMES-1)],frame,UPLOAD_FRAME_SIZE);
+		++retx_head;
+		if(sess_enable && ++sess_since_mark >= sess_window){
+			sess_since_mark = 0;
+			sessMarkSend();
+		}
 }
 
-void debugModeSet(){
-	if(uartCtrl.flagMask & DebugMode){
-		flag_fashion = Lock;
-		while(uartCtrl.flagMask & DebugMode) {
-			// 仅调整舵机位置，和激光器工作状态，工作时序通过定时器完成
-			HAL_GPIO_WritePin(GPIOA,E1_Pin | W1_Pin,uartCtrl.flagMask & Lidar1);
-			HAL_GPIO_WritePin(GPIOC,S1_Pin | N1_Pin,uartCtrl.flagMask & Lidar1);			
-			HAL_GPIO_WritePin(GPIOA,E2_Pin | W2_Pin,uartCtrl.flagMask & Lidar2);
-			HAL_GPIO_WritePin(GPIOC,S2_Pin | N2_Pin,uartCtrl.flagMask & Lidar2);			
-			HAL_GPIO_WritePin(GPIOA,E3_Pin | W3_Pin,uartCtrl.flagMask & Lidar3);
-			HAL_GPIO_WritePin(GPIOC,S3_Pin | N3_Pin,uartCtrl.flagMask & Lidar3);
-			while(flag_fashion == Lock){
-				fashion_send_single_angle(0, uartCtrl.posSet, uartCtrl.fashionTime);
-				HAL_Delay(uartCtrl.fashionTime + uartCtrl.lidarTime);
+/**
+  * @brief 组装差分紧凑帧：对照参考帧，只携带变化位图与变化字段
+  * @return 帧总长度
+  * @note 布局：0xA9 0xB4 | 位图2字节(小端) | 变化字段按位图顺序 |
+  *       主帧2 子帧2 时间戳4(恒带) | CRC8(字节2..尾前) | 0x33
+  *       位图：bit0-3 adc通道，bit4-11 sdadc通道，bit12 adj整组，
+  *       bit13 激光器状态+抽取因子
+  */
+static uint8_t uploadBuildDelta(uint8_t *frame, const UploadSnap *snap){
+		uint16_t bitmap = 0;
+		uint8_t len = 4;	//帧头2 + 位图2
+		for(uint8_t i = 0; i < 4; i++){
+			if(snap->adc[i] != delta_ref.adc[i]){
+				bitmap |= (uint16_t)(1u << i);
+			}
+		}
+		for(uint8_t i = 0; i < 8; i++){
+			if(snap->sdadc[i] != delta_ref.sdadc[i]){
+				bitmap |= (uint16_t)(1u << (4 + i));
+			}
+		}
+		if(memcmp(snap->adj,delta_ref.adj,sizeof(snap->adj)) != 0){
+			bitmap |= 0x1000;
+		}
+		if(snap->lidar != delta_ref.lidar || snap->decim != delta_ref.decim){
+			bitmap |= 0x2000;
+		}
+		frame[0]=0xA9;
+		frame[1]=0xB4;
+		frame[2]=(uint8_t)bitmap;
+		frame[3]=(uint8_t)(bitmap >> 8);
+		for(uint8_t i = 0; i < 4; i++){
+			if(bitmap & (1u << i)){
+				memcpy(&frame[len],&snap->adc[i],2);
+				len += 2;
+			}
+		}
+		for(uint8_t i = 0; i < 8; i++){
+			if(bitmap & (1u << (4 + i))){
+				memcpy(&frame[len],&snap->sdadc[i],2);
+				len += 2;
+			}
+		}
+		if(bitmap & 0x1000){
+			memcpy(&frame[len],snap->adj,sizeof(snap->adj));
+			len += 8;
+		}
+		if(bitmap & 0x2000){
+			frame[len++] = snap->lidar;
+			frame[len++] = snap->decim;
+		}
+		memcpy(&frame[len],&snap->master,2);
+		len += 2;
+		memcpy(&frame[len],&snap->pos,2);
+		len += 2;
+		memcpy(&frame[len],&snap->us,4);	//时间戳与序号一样恒带
+		len += 4;
+		frame[len]=(uint8_t)HAL_CRC_Calculate(&hcrc,(uint32_t*)&frame[2],(uint32_t)(len - 2));
+		len++;
+		frame[len++]=0x33;
+		return len;
+}
+
+/**
+  * @brief 捕获环尾部向发送环搬运
+  * @note 发送环空间不足时让步，下轮主循环继续——程间空档自然形成大段突发
+  */
+static void sweepCaptureDrain(void){
+		while(sweep_cap_tail != sweep_cap_head){
+			if((uint16_t)(TXRING_SIZE - txRingPending()) < UPLOAD_FRAME_SIZE){
+				break;
 			}
-			if(HAL_TIM_Base_GetState(&htim4)==HAL_TIM_STATE_READY){
-				HAL_TIM_Base_Start_IT(&htim4); 	//发送串口数据
+			if(txRingSend(sweep_cap[sweep_cap_tail & (SWEEP_CAP_FRAMES-1)],UPLOAD_FRAME_SIZE)){
+				++cnt_frames_sent;
 			}
-			HAL_Delay(uartCtrl.lidarTime);
+			++sweep_cap_tail;
+		}
+}
+
+void dataUploadProcess(void){
+		// 主循环侧：从快照环取数组帧并发送，运行在所有采集中断之下
+		while(snap_tail != snap_head){
+			uint32_t t0 = perfNow();
+			UploadSnap *snap = &upload_snap[snap_tail & (UPLOAD_SNAP_DEPTH-1)];
+			if((uartCtrl.flagMask & CaptureMode) && (uartCtrl.flagMask & DMode)){
+				// 整程捕获：帧只进RAM捕获环，扫描驻留节拍不被串口带宽限速
+				if((uint16_t)(sweep_cap_head - sweep_cap_tail) >= SWEEP_CAP_FRAMES){
+					++sweep_cap_dropped;	//捕获环满且链路持续跟不上，丢弃本帧
+				}else{
+					uploadBuildFrame(sweep_cap[sweep_cap_head & (SWEEP_CAP_FRAMES-1)],snap);
+					++sweep_cap_head;
+				}
+			}else if(delta_enable && delta_ref_valid && delta_since_key < delta_keyint){
+				// 差分帧不定长，不进定长批量暂存区，直接入发送环
+				uint8_t dframe[DELTA_FRAME_MAX];
+				uint8_t dlen = uploadBuildDelta(dframe,snap);
+				if(txRingSend(dframe,dlen)){
+					++cnt_frames_sent;
+				}
+				++delta_since_key;
+				delta_ref = *snap;
+			}else{
+				uploadBuildFrame(data_frame_upload[upload_build],snap);
+				delta_ref = *snap;
+				delta_ref_valid = delta_enable;	//关键帧建立参考
+				delta_since_key = 0;
+				++upload_build;
+				if(delta_enable || upload_build >= uartCtrl.uploadBatch || upload_build >= UPLOAD_BATCH_MAX){
+					dataUploadFlush();	//凑满一批整批发出；差分模式下关键帧立即发出保证帧序
+				}
+			}
+			++snap_tail;
+			if(ctr_period != 0 && ++ctr_since >= ctr_period){
+				ctr_since = 0;
+				countersSend();	//随数据流每N帧穿插一帧计数器
+			}
+			perfRecord(PERF_UPLOAD, t0);	//单帧组帧耗时（空转不计入）
+		}
+		sweepCaptureDrain();	//捕获环程中/程间搬运
+}
+
+/**
+  * @brief 将暂存区中已积累的完整帧整批入发送环
+  * @note 批量模式下摊薄每帧的DMA启动/完成开销；模式切换或修改批量参数时也用于冲刷残留帧
+  */
+void dataUploadFlush(void){
+	if(upload_build == 0){
+		return;
+	}
+	if(txRingSend(&data_frame_upload[0][0], (uint16_t)(upload_build * UPLOAD_FRAME_SIZE))){
+		cnt_frames_sent += upload_build;
+	}
+	upload_build = 0;
+}
+
+/**
+  * @brief 幅值统计窗口完成后组帧发送
+  * @note 主循环调用。帧布局：0xA9 0xB9 | 窗口样本数2字节(小端) |
+  *       8通道×(min2 max2 mean2 饱和计数2)(小端) | 0x33
+  */
+void statsUploadProcess(void){
+	static uint8_t frame[STATS_FRAME_SIZE];
+	uint8_t *p = frame;
+	if(stat_ready == 0){
+		return;
+	}
+	*p++ = 0xA9;
+	*p++ = 0xB9;
+	memcpy(p,&stat_latch.count,2); p += 2;
+	for(uint8_t i = 0; i < 8; i++){
+		int16_t mean = (stat_latch.count != 0) ? (int16_t)(stat_latch.sum[i] / stat_latch.count) : 0;
+		memcpy(p,&stat_latch.min[i],2); p += 2;
+		memcpy(p,&stat_latch.max[i],2); p += 2;
+		memcpy(p,&mean,2); p += 2;
+		memcpy(p,&stat_latch.sat[i],2); p += 2;
+	}
+	*p = 0x33;
+	txRingSend(frame,STATS_FRAME_SIZE);
+	stat_ready = 0;
+}
+
+/**
+  * @brief 串口发送完成回调：推进发送环读指针并接力下一段
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart){
+	if(huart == &huart2){
+		txRingTxCplt();
+	}
+	else if(huart == &huart1){
+		fashion_tx_complete();	//释放舵机指令槽位并链式发送下一条
+	}
+}
+
+void debugModeSet(){
+	static ScanTimer dbg_timer;
+	if((uartCtrl.flagMask & DebugMode) == 0){
+		dbg_entered = 0;
+		return;
+	}
+	if(dbg_entered == 0){
+		// 进入debug模式：锁定舵机并请求到测量点
+		dbg_entered = 1;
+		flag_fashion = Lock;
+		scanEventClear();
+		fashion_send_single_angle(0, uartCtrl.posSet, uartCtrl.fashionTime);
+		scanTimerStart(&dbg_timer, uartCtrl.fashionTime + uartCtrl.lidarTime);
+		return;
+	}
+	// 仅调整舵机位置，和激光器工作状态，工作时序通过定时器完成
+	HAL_GPIO_WritePin(GPIOA,E1_Pin | W1_Pin,uartCtrl.flagMask & Lidar1);
+	HAL_GPIO_WritePin(GPIOC,S1_Pin | N1_Pin,uartCtrl.flagMask & Lidar1);
+	HAL_GPIO_WritePin(GPIOA,E2_Pin | W2_Pin,uartCtrl.flagMask & Lidar2);
+	HAL_GPIO_WritePin(GPIOC,S2_Pin | N2_Pin,uartCtrl.flagMask & Lidar2);
+	HAL_GPIO_WritePin(GPIOA,E3_Pin | W3_Pin,uartCtrl.flagMask & Lidar3);
+	HAL_GPIO_WritePin(GPIOC,S3_Pin | N3_Pin,uartCtrl.flagMask & Lidar3);
+	if(flag_fashion == Lock){
+		// 未收到完成回包，按原有节拍超时重发，不再阻塞等待
+		if(scanTimerExpired(&dbg_timer)){
+			fashion_send_single_angle(0, uartCtrl.posSet, uartCtrl.fashionTime);
+			scanTimerStart(&dbg_timer, uartCtrl.fashionTime + uartCtrl.lidarTime);
 		}
+		return;
+	}
+	if(HAL_TIM_Base_GetState(&htim4)==HAL_TIM_STATE_READY){
+		HAL_TIM_Base_Start_IT(&htim4); 	//发送串口数据
 	}
 };
+/**
+  * @brief 按指定波特率重配USART2并重挂指令接收
+  */
+static void baudApply(uint32_t baud){
+	huart2.Init.BaudRate = baud;
+	HAL_UART_Init(&huart2);
+	HAL_UARTEx_ReceiveToIdle_IT(&huart2,recv_frame2,FRAMESIZE);
+}
+
+void baudNegotiateProcess(){
+	if(baud_state == 1){
+		if(txRingPending() == 0 || scanTimerExpired(&baud_timer)){
+			// 旧速率应答已全部上线（或上行饱和排空超时，强制切换）。
+			// 应答已发出：上位机收到则已在新速率等待；没收到也有
+			// 确认超时兜底——无确认帧即自动回退旧速率，两侧不失联
+			baudApply(baud_pending);
+			scanTimerStart(&baud_timer, BAUD_CONFIRM_TIMEOUT);
+			baud_state = 2;
+		}
+	}else if(baud_state == 2){
+		if(scanTimerExpired(&baud_timer)){
+			baudApply(baud_fallback);	//确认超时，自动回退旧速率保住链路
+			baud_state = 0;
+		}
+	}
+};
+
+void benchModeSet(){
+	static uint8_t bench_frame[UPLOAD_FRAME_SIZE];
+	UploadSnap snap;
+	if((uartCtrl.flagMask & BenchMode) == 0){
+		bench_entered = 0;
+		return;
+	}
+	if(bench_entered == 0){
+		// 进入基准模式：停掉采样节拍，序号/计数清零，主循环满速生成
+		bench_entered = 1;
+		bench_offered = 0;
+		bench_sent = 0;
+		data_frame_master = 0;
+		data_frame_pos = 0;
+		if(HAL_TIM_Base_GetState(&htim4)==HAL_TIM_STATE_BUSY){
+			HAL_TIM_Base_Stop_IT(&htim4);
+		}
+	}
+	// 已知图样+递增序号的合成帧：每轮主循环提交一帧，发送环满即计为
+	// 丢帧但序号照常推进——上位机按master/pos缺口核对即得链路实测上限
+	for(uint8_t i = 0; i < 4; i++){
+		snap.adc[i] = (uint16_t)(0xA500 | i);
+	}
+	for(uint8_t i = 0; i < 8; i++){
+		snap.sdadc[i] = (int16_t)(0x5A00 | i);
+	}
+	memset(snap.adj,0x5A,sizeof(snap.adj));
+	snap.master = data_frame_master;
+	snap.pos = data_frame_pos;
+	snap.lidar = 0;
+	snap.decim = 1;
+	snap.us = timeMicros();
+	uploadBuildFrame(bench_frame,&snap);
+	++bench_offered;
+	if(txRingSend(bench_frame,UPLOAD_FRAME_SIZE)){
+		++bench_sent;
+	}
+	++data_frame_pos;
+	if(data_frame_pos == 0){
+		++data_frame_master;	//子帧序号回绕进位
+	}
+};
+
 void cModeSet(){
-	if(uartCtrl.flagMask & CMode){
-		// 初始化舵机位置
+	static CScanState cstate = CSCAN_HOME_WAIT;
+	static ScanTimer ctimer;		//阶段截止定时器
+	static ScanTimer cpoll;			//角度回读节拍定时器
+	static int16_t target;
+
+	if((uartCtrl.flagMask & CMode) == 0){
+		cscan_entered = 0;
+		return;
+	}
+	if(cscan_entered == 0){
+		// 初始化舵机位置，并开启角度监控流（舵机持续推送angle_read影子值）
+		cscan_entered = 1;
 		flag_fashion = Lock;
-		while(flag_fashion == Lock){
-			fashion_send_single_angle(0, uartCtrl.posLow, uartCtrl.fashionTime);//启动舵机到初始位置posLow
-			HAL_Delay(uartCtrl.fashionTime + uartCtrl.lidarTime);
-		}
+		scanEventClear();
+		fashion_monitor_data(0, FASHION_MONITOR_ANGLE);
+		fashion_send_single_angle(0, uartCtrl.posLow, uartCtrl.fashionTime);//启动舵机到初始位置posLow
+		scanTimerStart(&ctimer, uartCtrl.fashionTime + uartCtrl.lidarTime);
+		cstate = CSCAN_HOME_WAIT;
+		return;
+	}
 
-		int16_t target;
-    while(uartCtrl.flagMask & CMode) {
+	switch(cstate){
+		case CSCAN_HOME_WAIT:
+			// 回包事件到达立即推进，超时重发
+			if(scanEventTake(SCAN_EVT_FASHION_DONE) || flag_fashion == Release){
+				cstate = CSCAN_LIDAR_SET;
+			}else if(scanTimerExpired(&ctimer)){
+				fashion_send_single_angle(0, uartCtrl.posLow, uartCtrl.fashionTime);
+				scanTimerStart(&ctimer, uartCtrl.fashionTime + uartCtrl.lidarTime);
+			}
+			break;
+		case CSCAN_LIDAR_SET:
 			// 设置激光器状态
 			HAL_GPIO_WritePin(GPIOA,E1_Pin | W1_Pin,mask_lidar[index_lidar] & 0x01);
 			HAL_GPIO_WritePin(GPIOC,S1_Pin | N1_Pin,mask_lidar[index_lidar] & 0x01);
 			HAL_GPIO_WritePin(GPIOA,E2_Pin | W2_Pin,mask_lidar[index_lidar] & 0x02);
 			HAL_GPIO_WritePin(GPIOC,S2_Pin | N2_Pin,mask_lidar[index_lidar] & 0x02);
-			HAL_Delay(uartCtrl.lidarTime);	//等待激光器启动
-
-			// 读取当前位置
-			while(angle_read != uartCtrl.posLow && angle_read != uartCtrl.posHigh){
+			scanTimerStart(&ctimer, uartCtrl.lidarTime);	//等待激光器启动
+			cstate = CSCAN_LIDAR_WAIT;
+			break;
+		case CSCAN_LIDAR_WAIT:
+			if(scanTimerExpired(&ctimer)){
+				scanTimerStart(&cpoll, CSCAN_MONITOR_TIMEOUT);
+				cstate = CSCAN_ANGLE_POLL;
+			}
+			break;
+		case CSCAN_ANGLE_POLL:
+			// 端点判断由监控流推送驱动，监控流静默时退回显式回读
+			if(angle_read == uartCtrl.posLow || angle_read == uartCtrl.posHigh){
+				cstate = CSCAN_SWEEP_START;
+			}else if(scanEventTake(SCAN_EVT_ANGLE_READ)){
+				scanTimerStart(&cpoll, CSCAN_MONITOR_TIMEOUT);	//监控流存活，复位静默超时
+			}else if(scanTimerExpired(&cpoll)){
 				fashion_read_servo_angle(0);
-				HAL_Delay(10);
+				scanTimerStart(&cpoll, CSCAN_MONITOR_TIMEOUT);
 			}
-
-			// 切换舵机目标位置
+			break;
+		case CSCAN_SWEEP_START:
+			// 切换舵机目标位置，启动舵机并开始发送数据
 			target = (angle_read == uartCtrl.posLow) ? uartCtrl.posHigh : uartCtrl.posLow;
-			
-			
-			// 启动舵机并开始发送数据
 			flag_fashion = Lock;
+			scanEventTake(SCAN_EVT_FASHION_DONE | SCAN_EVT_ANGLE_READ);
 			fashion_send_single_angle(0, target, uartCtrl.fashionTime);
 			data_frame_pos = 0;		//子帧计数清零
 			HAL_TIM_Base_Start_IT(&htim4); // 启动定时器发送数据
-			
-			
-			// 重试机制，确保舵机到达目标位置
-			HAL_Delay(uartCtrl.lidarTime);
-			if(flag_fashion == Lock){
-				fashion_send_single_angle(0, target, uartCtrl.fashionTime);//启动舵机到初始位置posLow
-				HAL_Delay(uartCtrl.lidarTime);
-			}
-			
-			// 等待舵机完成
-			HAL_Delay(uartCtrl.fashionTime);
-			
-			// 关闭定时器
-			HAL_TIM_Base_Stop_IT(&htim4);
-			
-			//读取当前角度信息
-			fashion_read_servo_angle(0);
-			
-			// 更新激光器索引
-			++index_lidar;
-			if(index_lidar >= 4) { // 完成一轮
-				index_lidar = 0;
-				++data_frame_master;
+			scanTimerStart(&ctimer, uartCtrl.fashionTime);	//最迟按运转周期结束本程
+			scanTimerStart(&cpoll, uartCtrl.lidarTime);			//指令未确认时的重发节拍
+			cstate = CSCAN_SWEEP_WAIT;
+			break;
+		case CSCAN_SWEEP_WAIT:
+			// 监控流推送角度到达目标即提前结束本程，无需等满fashionTime
+			if(angle_read == target || scanTimerExpired(&ctimer)){
+				HAL_TIM_Base_Stop_IT(&htim4);
+				// 更新激光器索引
+				++index_lidar;
+				if(index_lidar >= 4) { // 完成一轮
+					index_lidar = 0;
+					++data_frame_master;
+				}
+				cstate = CSCAN_LIDAR_SET;
+			}else if(flag_fashion == Lock && scanTimerExpired(&cpoll)){
+				// 重试机制，确保舵机收到启动指令
+				fashion_send_single_angle(0, target, uartCtrl.fashionTime);
+				scanTimerStart(&cpoll, uartCtrl.lidarTime);
+			}else if(flag_fashion == Release && scanEventTake(SCAN_EVT_ANGLE_READ)){
+				scanTimerStart(&cpoll, CSCAN_MONITOR_TIMEOUT);	//监控流存活，复位静默超时
+			}else if(flag_fashion == Release && (cpoll.armed == 0 || scanTimerExpired(&cpoll))){
+				// 监控流静默，退回显式回读
+				fashion_read_servo_angle(0);
+				scanTimerStart(&cpoll, CSCAN_MONITOR_TIMEOUT);
 			}
-    }
+			break;
+		default:
+			cstate = CSCAN_HOME_WAIT;
+			break;
 	}
 };
 
 void dModeSet(){
-		if(uartCtrl.flagMask & DMode){
-		data_frame_pos = uartCtrl.posLow;
+	static DScanState dstate = DSCAN_MOVE;
+	static ScanTimer dtimer;		//阶段截止定时器
+	static uint8_t retry_count = 0;
+	const uint8_t MAX_RETRY = 3; // 最大重试次数
+
+	if((uartCtrl.flagMask & DMode) == 0){
+		dscan_entered = 0;
+		return;
+	}
+	if(dscan_entered == 0){
+		dscan_entered = 1;
 		index_lidar = 0;
-		uint8_t direction = 1; // 1表示正向扫描，0表示反向扫描
-		uint16_t angle_read[1] = {0}; // 用于存储读取的舵机角度
-		uint8_t position_reached = 0;
-		uint8_t retry_count = 0;
-		const uint8_t MAX_RETRY = 3; // 最大重试次数
-    
-		while(uartCtrl.flagMask & DMode) {
-			// 初始化位置标志和重试计数
-			position_reached = 0;
+		mask_scan_step = 0;
+		mask_scan_dir = 0;
+		scanEventClear();
+		// 整程位置序列一次性下放到舵机层，由轨迹流负责折返与预取
+		fashion_traj_start(uartCtrl.posLow, uartCtrl.posHigh, uartCtrl.posDiv, uartCtrl.fashionTime);
+		data_frame_pos = fashion_traj_target();
+		retry_count = 0;
+		scanTimerStart(&dtimer, uartCtrl.fashionTime + uartCtrl.lidarTime);
+		dstate = DSCAN_MOVE_WAIT;
+	}
+
+	switch(dstate){
+		case DSCAN_MOVE:
+			// 轨迹流推进下一点：预构建报文立即上总线
+			fashion_traj_advance();
+			data_frame_pos = fashion_traj_target();
 			retry_count = 0;
-			
-			// 检查并修正舵机位置范围
-			if(data_frame_pos < uartCtrl.posLow) {
-				data_frame_pos = uartCtrl.posLow;
-				direction = 1;
-			} else if(data_frame_pos > uartCtrl.posHigh) {
-				data_frame_pos = uartCtrl.posHigh;
-				direction = 0;
-			}
-			
-			// 发送舵机到目标位置
-			fashion_send_single_angle(0, data_frame_pos, uartCtrl.fashionTime);
-			
-			// 等待舵机到达目标位置（带重试机制）
-			while(!position_reached && retry_count < MAX_RETRY) {
-				HAL_Delay(uartCtrl.fashionTime); // 等待舵机动作
-				HAL_Delay(uartCtrl.lidarTime); // 等待激光器启动时间
-				
-				// 读取实际舵机角度
+			scanTimerStart(&dtimer, uartCtrl.fashionTime + uartCtrl.lidarTime);
+			dstate = DSCAN_MOVE_WAIT;
+			break;
+		case DSCAN_MOVE_WAIT:
+			// 到位事件或角度影子值命中则立即推进，否则等满动作周期后回读校验
+			if(scanEventTake(SCAN_EVT_TRAJ_POINT) || angle_read == data_frame_pos){
+				dstate = DSCAN_SETTLE;
+			}else if(scanTimerExpired(&dtimer)){
 				fashion_read_servo_angle(0);
-				
-				// 检查舵机是否到达目标位置
-				if(angle_read[0] == data_frame_pos) {
-					position_reached = 1;
-				} else {
-					retry_count++;
-					// 重新发送舵机到目标位置
-					fashion_send_single_angle(0, data_frame_pos, uartCtrl.fashionTime);
-				}
+				scanTimerStart(&dtimer, 10);	//等待回读回包
+				dstate = DSCAN_VERIFY;
 			}
-			
-			// 只有当舵机到达目标位置时才继续
-			if(position_reached) {
-				// 依次开启激光器
-				HAL_GPIO_WritePin(GPIOA, E1_Pin | W1_Pin, mask_lidar[index_lidar] & 0x01);
-				HAL_GPIO_WritePin(GPIOC, S1_Pin | N1_Pin, mask_lidar[index_lidar] & 0x01);
-				HAL_GPIO_WritePin(GPIOA, E2_Pin | W2_Pin, mask_lidar[index_lidar] & 0x02);
-				HAL_GPIO_WritePin(GPIOC, S2_Pin | N2_Pin, mask_lidar[index_lidar] & 0x02);
-				
-				// 等待激光器稳定
-				HAL_Delay(uartCtrl.lidarTime);
-				
-				// 等待自动增益调节完成
-				while(mutex_autoadj != 0) {
-					HAL_Delay(1);
+			break;
+		case DSCAN_VERIFY:
+			// 检查舵机是否到达目标位置（带重试机制）
+			if(angle_read == data_frame_pos){
+				dstate = DSCAN_SETTLE;
+			}else if(scanTimerExpired(&dtimer)){
+				retry_count++;
+				++cnt_servo_retry;
+				if(retry_count >= MAX_RETRY){
+					// 超过重试次数，关闭激光器后重发当前点重新定位
+					HAL_GPIO_WritePin(GPIOA, E1_Pin | W1_Pin | E2_Pin | W2_Pin, GPIO_PIN_RESET);
+					HAL_GPIO_WritePin(GPIOC, S1_Pin | N1_Pin | S2_Pin | N2_Pin, GPIO_PIN_RESET);
+					mask_applied = 0;
+					retry_count = 0;
 				}
-				
+				// 重新发送舵机到当前轨迹点
+				fashion_traj_resend();
+				scanTimerStart(&dtimer, uartCtrl.fashionTime + uartCtrl.lidarTime);
+				dstate = DSCAN_MOVE_WAIT;
+			}
+			break;
+		case DSCAN_SETTLE:
+		{
+			// 按格雷序施加本位置下一组掩码，逐位置往返使衔接处掩码不变
+			uint8_t step = mask_scan_dir ? (uint8_t)(3 - mask_scan_step) : mask_scan_step;
+			index_lidar = mask_scan_order[step];
+			uint8_t mask = mask_lidar[index_lidar];
+			HAL_GPIO_WritePin(GPIOA, E1_Pin | W1_Pin, mask & 0x01);
+			HAL_GPIO_WritePin(GPIOC, S1_Pin | N1_Pin, mask & 0x01);
+			HAL_GPIO_WritePin(GPIOA, E2_Pin | W2_Pin, mask & 0x02);
+			HAL_GPIO_WritePin(GPIOC, S2_Pin | N2_Pin, mask & 0x02);
+			// 有激光器通断才需等光学稳定；暗场或掩码未变只等短延时
+			if(mask != 0x00 && mask != mask_applied){
+				scanTimerStart(&dtimer, uartCtrl.lidarTime);
+			}else{
+				scanTimerStart(&dtimer, DSCAN_DARK_SETTLE);
+			}
+			mask_applied = mask;
+			dstate = DSCAN_GAIN_WAIT;
+			break;
+		}
+		case DSCAN_GAIN_WAIT:
+			// 激光器稳定且自动增益调节完成后上传
+			if(scanTimerExpired(&dtimer) == 0 && dtimer.armed){
+				break;
+			}
+			if(mutex_autoadj == 0){
 				// 上传当前数据
-				dataUpload();
-				
-				// 更新激光器索引
-				index_lidar++;
-				if(index_lidar > 3) {
-					index_lidar = 0;
-					
-					// 实现来回扫描逻辑
-					if(direction) {
-						// 正向扫描
-						data_frame_pos += uartCtrl.posDiv;
-						// 如果到达上边界，改变方向
-						if(data_frame_pos > uartCtrl.posHigh) {
-							direction = 0;
-							data_frame_pos = uartCtrl.posHigh - uartCtrl.posDiv;
-							// 确保不小于最小值
-							if(data_frame_pos < uartCtrl.posLow) {
-								data_frame_pos = uartCtrl.posLow;
-							}
-						}
-					} else {
-						// 反向扫描
-						data_frame_pos -= uartCtrl.posDiv;
-						// 如果到达下边界，改变方向
-						if(data_frame_pos < uartCtrl.posLow) {
-							direction = 1;
-							data_frame_pos = uartCtrl.posLow + uartCtrl.posDiv;
-							// 确保不大于最大值
-							if(data_frame_pos > uartCtrl.posHigh) {
-								data_frame_pos = uartCtrl.posHigh;
-							}
-						}
-					}
-					
+				dataUploadSnap();
+				// 更新掩码扫描进度
+				mask_scan_step++;
+				if(mask_scan_step > 3) {
+					mask_scan_step = 0;
+					mask_scan_dir ^= 1;	//下一位置逆序遍历，衔接处掩码免重新稳定
+					// 本点四组掩码采集完毕，来回折返由轨迹流负责
 					// 主帧序号自增
 					data_frame_master++;
+					// 激光器保持现状随动到下一点，到位后从同一掩码继续
+					dstate = DSCAN_MOVE;
+				}else{
+					// 同一点继续下一组激光器掩码
+					dstate = DSCAN_SETTLE;
 				}
 			}
-			
-			// 关闭所有激光器
-			HAL_GPIO_WritePin(GPIOA, E1_Pin | W1_Pin | E2_Pin | W2_Pin, GPIO_PIN_RESET);
-			HAL_GPIO_WritePin(GPIOC, S1_Pin | N1_Pin | S2_Pin | N2_Pin, GPIO_PIN_RESET);
-    }
+			break;
+		default:
+			dstate = DSCAN_MOVE;
+			break;
 	}
 };
 
@@ -540,13 +1552,33 @@ void modeInit(){
 	if(HAL_TIM_Base_GetState(&htim4)==HAL_TIM_STATE_BUSY){
 		HAL_TIM_Base_Stop_IT(&htim4); 	//关闭自动上传
 	}
+	dataUploadFlush();	//冲刷批量暂存区残留帧
+	sweep_cap_tail = sweep_cap_head;	//丢弃残程捕获帧，序号即将复位
+	retx_head = 0;	//清空重传历史窗，避免复位后的序号命中旧帧
+	sess_acked = 0;	//记录序号复位，会话确认基准随之对齐
+	sess_since_mark = 0;
+	delta_ref_valid = 0;	//差分参考帧作废，模式切换后从关键帧重新开始
+	delta_since_key = 0;
+	// 丢弃抽取半程累加，避免上一模式的残余采样混入新模式首帧
+	memset(decim_adc_sum,0,sizeof(decim_adc_sum));
+	memset(decim_sdadc_sum,0,sizeof(decim_sdadc_sum));
+	decim_count = 0;
 	if(uartCtrl.flagMask==0){
 		HAL_TIM_Base_Start_IT(&htim4);
 	}
 	flag_fashion = Release;
+	fashion_traj_stop();	//终止轨迹流，模式切换后由扫描状态机重新下放
 	index_lidar = 0;
+	mask_scan_step = 0;
+	mask_scan_dir = 0;
 	data_frame_master = 0;
 	data_frame_pos = 0;
+	// 复位扫描状态机，模式切换后重新推进
+	dbg_entered = 0;
+	cscan_entered = 0;
+	dscan_entered = 0;
+	bench_entered = 0;
+	scanEventClear();
 }
 /* USER CODE END 4 */
 
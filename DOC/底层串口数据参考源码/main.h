@@ -49,16 +49,28 @@ typedef struct {
 	uint16_t uartUploadTime;		//串口数据上传周期(采样率)
 	uint16_t fashionTime;				//舵机单角度运行周期(a)
 	uint16_t lidarTime;					//激光器启动延时(b)
+	uint16_t uploadBatch;				//批量上传帧数(1=逐帧发送)
+	uint16_t decimFactor;				//过采样抽取因子K(1=不抽取)
 }ControlParams;
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
-#define BUFFERSIZE 200           					//可以接收的最大字符个数   
-#define FRAMESIZE 50           	//可以接收的最大字符个数   
+#define BUFFERSIZE 200           					//可以接收的最大字符个数
+#define FRAMESIZE 50           	//可以接收的最大字符个数
+#define UPLOAD_FRAME_SIZE 46					//上传数据帧长度(含微秒时间戳与CRC校验字节)
+#define DELTA_FRAME_MAX 48						//差分紧凑帧最大长度(全字段变化时)
+#define UPLOAD_BATCH_MAX 8						//批量上传暂存区最大帧数
+#define DECIM_FACTOR_MAX 64						//过采样抽取因子上限
+#define UPLOAD_SNAP_DEPTH 8						//上传快照环深度（2的幂）
+#define SDADC_RING_FRAMES 8						//SDADC环形采集缓冲帧数（2的幂）
+#define SWEEP_CAP_FRAMES 256					//整程捕获环帧数（2的幂）
+#define RETX_FRAMES 32								//重传历史窗帧数（2的幂）
 #define DebugMode 0x0001					//Debug模式
 #define CMode 0x0002					//连续模式
 #define DMode 0x0004					//离散模式
+#define CaptureMode 0x0008		//整程捕获模式(dMode下帧先入RAM捕获环)
+#define BenchMode 0x0100			//链路基准模式(满速合成帧测量链路上限)
 #define Lidar1 0x10 				//激光器1
 #define Lidar2 0x20					//激光器2
 #define Lidar3 0x40					//激光器3
@@ -85,7 +97,7 @@ extern uint8_t readadj;
 extern ControlParams uartCtrl;
 extern uint8_t mutex_autoadj;	//自动增益调节过程中的锁
 extern uint8_t flag_fashion;		//舵机执行指令成功
-extern uint8_t data_frame_upload[40];
+extern uint8_t data_frame_upload[UPLOAD_BATCH_MAX][UPLOAD_FRAME_SIZE];	//批量组帧暂存区
 extern uint8_t mask_lidar[4];	//00 01 10 11 ....111 000当前只有两个激光器
 extern uint8_t index_lidar;			//激光器开启状态（掩码索引）
 extern uint16_t data_frame_master;//主帧序号
@@ -106,9 +118,14 @@ void setCtrlParams(void);
 void debugModeSet(void);
 void cModeSet(void);
 void dModeSet(void);
-void dataUpload(void);
+void benchModeSet(void);
+void baudNegotiateProcess(void);
+void dataUploadSnap(void);
+void dataUploadProcess(void);
+void dataUploadFlush(void);
+void statsUploadProcess(void);
 void modeInit(void);
-void fashion_process_response(uint8_t length);
+void fashion_rx_scan(uint16_t dma_head);	//huart1接收事件回调入口：零拷贝扫描DMA环并分发回包
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
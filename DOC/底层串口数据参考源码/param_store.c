@@ -0,0 +1,84 @@
+#include "param_store.h"
+
+uint8_t param_store_loaded = 0;
+
+// FLASH记录布局（按半字对齐，F3按半字编程）：
+// [0] magic  [1] 参数字节数  [2..] ControlParams  [末] 16位累加校验
+typedef struct {
+	uint16_t magic;					//有效记录标识
+	uint16_t size;					//参数结构字节数，结构演进后旧记录自动失效
+	ControlParams params;		//参数本体
+	uint16_t checksum;			//对magic/size/params逐半字累加
+}ParamRecord;
+
+/**
+ * @brief 逐半字累加校验（不依赖CRC外设，便于在外设初始化前校验）
+ */
+static uint16_t paramChecksum(const ParamRecord *rec)
+{
+	const uint16_t *p = (const uint16_t *)rec;
+	uint16_t sum = 0;
+	for(uint16_t i = 0; i < (sizeof(ParamRecord) - sizeof(uint16_t)) / 2; i++){
+		sum += p[i];
+	}
+	return sum;
+}
+
+/**
+ * @brief 将当前uartCtrl写入FLASH参数页
+ * @return 1成功 0擦除或编程失败
+ * @note 由"提交参数"指令显式触发，避免每次改参都磨损FLASH
+ */
+uint8_t paramStoreSave(void)
+{
+	ParamRecord rec;
+	FLASH_EraseInitTypeDef erase;
+	uint32_t page_err;
+	const uint16_t *src = (const uint16_t *)&rec;
+
+	rec.magic = PARAM_STORE_MAGIC;
+	rec.size = sizeof(ControlParams);
+	rec.params = uartCtrl;
+	rec.checksum = paramChecksum(&rec);
+
+	HAL_FLASH_Unlock();
+	erase.TypeErase = FLASH_TYPEERASE_PAGES;
+	erase.PageAddress = PARAM_STORE_ADDR;
+	erase.NbPages = 1;
+	if(HAL_FLASHEx_Erase(&erase, &page_err) != HAL_OK){
+		HAL_FLASH_Lock();
+		return 0;
+	}
+	for(uint16_t i = 0; i < sizeof(ParamRecord) / 2; i++){
+		if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD,
+				PARAM_STORE_ADDR + i * 2, src[i]) != HAL_OK){
+			HAL_FLASH_Lock();
+			return 0;
+		}
+	}
+	HAL_FLASH_Lock();
+	return 1;
+}
+
+/**
+ * @brief 上电时从FLASH恢复uartCtrl
+ * @return 1恢复成功 0无有效记录（保持调用前的默认值）
+ * @note 在模式初始化之前调用；校验magic/长度/累加和三重防护，
+ *       结构变更或记录损坏时静默回落到固件默认参数
+ */
+uint8_t paramStoreRestore(void)
+{
+	const ParamRecord *rec = (const ParamRecord *)PARAM_STORE_ADDR;
+	if(rec->magic != PARAM_STORE_MAGIC){
+		return 0;
+	}
+	if(rec->size != sizeof(ControlParams)){
+		return 0;
+	}
+	if(rec->checksum != paramChecksum(rec)){
+		return 0;
+	}
+	uartCtrl = rec->params;
+	param_store_loaded = 1;
+	return 1;
+}
@@ -0,0 +1,24 @@
+#ifndef __PARAM_STORE_H
+#define __PARAM_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// ControlParams的FLASH持久化：占用最后一页(2KB)，上电恢复后
+// 无需上位机重放配置即可按上次工作模式自主开始扫描
+#define PARAM_STORE_ADDR		0x0803F800UL	//最后一页起始地址(256KB器件)
+#define PARAM_STORE_MAGIC		0xA5C3				//有效记录标识
+
+extern uint8_t param_store_loaded;	//本次上电是否从FLASH恢复了配置
+
+uint8_t paramStoreSave(void);
+uint8_t paramStoreRestore(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_STORE_H */
@@ -0,0 +1,28 @@
+#include "perf_probe.h"
+
+PerfStat perf_stats[PERF_PROBE_COUNT];
+
+/**
+ * @brief 清零全部探针统计
+ */
+void perfReset(void)
+{
+	for(uint8_t i = 0; i < PERF_PROBE_COUNT; i++){
+		perf_stats[i].min = 0xFFFFFFFF;
+		perf_stats[i].max = 0;
+		perf_stats[i].sum = 0;
+		perf_stats[i].count = 0;
+	}
+}
+
+/**
+ * @brief 使能DWT周期计数器并清零统计
+ * @note 上电调用一次；计数器自由运行，探针两端读数相减即为耗时
+ */
+void perfInit(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	perfReset();
+}
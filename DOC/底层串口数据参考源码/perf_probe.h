@@ -0,0 +1,64 @@
+#ifndef __PERF_PROBE_H
+#define __PERF_PROBE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// 基于Cortex-M DWT周期计数器的热路径打点：每个探针只做一次减法和
+// min/max/累加更新（数个周期），可常开在量产固件中
+enum {
+	PERF_UPLOAD = 0,			//dataUploadProcess单帧组帧耗时
+	PERF_CMD_DISPATCH,		//setCtrlParams指令分发耗时
+	PERF_TIM4_ISR,				//TIM4中断(采样快照)耗时
+	PERF_FASHION_RTT,			//舵机指令发出到回包的总线往返
+	PERF_PROBE_COUNT
+};
+
+typedef struct {
+	uint32_t min;		//最小周期数
+	uint32_t max;		//最大周期数
+	uint32_t sum;		//累计周期数
+	uint32_t count;	//采样次数
+}PerfStat;
+
+extern PerfStat perf_stats[PERF_PROBE_COUNT];
+
+/**
+ * @brief 读取当前DWT周期计数
+ */
+static inline uint32_t perfNow(void)
+{
+	return DWT->CYCCNT;
+}
+
+/**
+ * @brief 记录一次从start到当前的耗时
+ * @param id 探针编号
+ * @param start 区间起点的perfNow()值
+ * @note 计数器回绕由无符号减法自然处理
+ */
+static inline void perfRecord(uint8_t id, uint32_t start)
+{
+	uint32_t d = DWT->CYCCNT - start;
+	PerfStat *s = &perf_stats[id];
+	if(d < s->min){
+		s->min = d;
+	}
+	if(d > s->max){
+		s->max = d;
+	}
+	s->sum += d;
+	++s->count;
+}
+
+void perfInit(void);
+void perfReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PERF_PROBE_H */
@@ -0,0 +1,72 @@
+#include "scan_scheduler.h"
+
+static volatile uint8_t scan_events = 0;	//事件集合：中断置位、主循环取走
+
+/**
+ * @brief 启动软件定时器
+ * @param timer 定时器对象
+ * @param ms 等待时长（毫秒）
+ */
+void scanTimerStart(ScanTimer *timer, uint32_t ms)
+{
+	timer->start = HAL_GetTick();
+	timer->span = ms;
+	timer->armed = 1;
+}
+
+/**
+ * @brief 停止软件定时器
+ * @param timer 定时器对象
+ */
+void scanTimerStop(ScanTimer *timer)
+{
+	timer->armed = 0;
+}
+
+/**
+ * @brief 查询定时器是否到期（未启动视为未到期，到期后自动停止）
+ * @param timer 定时器对象
+ * @return 1到期 0未到期
+ */
+uint8_t scanTimerExpired(ScanTimer *timer)
+{
+	if(timer->armed == 0){
+		return 0;
+	}
+	if((uint32_t)(HAL_GetTick() - timer->start) >= timer->span){
+		timer->armed = 0;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief 置位扫描事件（中断上下文调用）
+ * @param events 事件位
+ */
+void scanEventSet(uint8_t events)
+{
+	scan_events |= events;
+}
+
+/**
+ * @brief 取走指定事件
+ * @param events 关注的事件位
+ * @return 实际发生的事件位，0表示未发生
+ */
+uint8_t scanEventTake(uint8_t events)
+{
+	uint8_t hit = scan_events & events;
+	if(hit != 0){
+		scan_events &= (uint8_t)~hit;
+	}
+	return hit;
+}
+
+/**
+ * @brief 清空全部事件（模式切换时调用）
+ */
+void scanEventClear(void)
+{
+	scan_events = 0;
+}
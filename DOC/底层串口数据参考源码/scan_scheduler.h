@@ -0,0 +1,34 @@
+#ifndef __SCAN_SCHEDULER_H
+#define __SCAN_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// 扫描事件位定义（中断上下文置位，扫描状态机取走）
+#define SCAN_EVT_FASHION_DONE	0x01	//舵机指令完成回包(flag_fashion释放)
+#define SCAN_EVT_ANGLE_READ		0x02	//舵机角度回读更新(angle_read有效)
+#define SCAN_EVT_TRAJ_POINT		0x04	//轨迹流当前点到位(fashion_traj_target有效)
+
+// 毫秒级软件定时器，基于HAL_GetTick，用于替代HAL_Delay的非阻塞等待
+typedef struct {
+	uint32_t start;		//启动时刻(ms)
+	uint32_t span;		//等待时长(ms)
+	uint8_t armed;		//是否在计时
+}ScanTimer;
+
+void scanTimerStart(ScanTimer *timer, uint32_t ms);
+void scanTimerStop(ScanTimer *timer);
+uint8_t scanTimerExpired(ScanTimer *timer);
+
+void scanEventSet(uint8_t events);
+uint8_t scanEventTake(uint8_t events);
+void scanEventClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCAN_SCHEDULER_H */
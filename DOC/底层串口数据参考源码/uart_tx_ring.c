@@ -0,0 +1,89 @@
+#include "uart_tx_ring.h"
+
+static uint8_t txring_buf[TXRING_SIZE];
+static volatile uint16_t txring_head = 0;				//写指针（生产者，只增不回绕取模）
+static volatile uint16_t txring_tail = 0;				//读指针（DMA消费者）
+static volatile uint16_t txring_active_len = 0;	//当前DMA在途长度，0表示链路空闲
+volatile uint32_t txring_dropped = 0;
+
+/**
+ * @brief 启动下一段DMA发送（取到缓冲区物理尾部的连续段）
+ * @note 仅在链路空闲或发送完成回调中调用
+ */
+static void txRingKick(void)
+{
+	uint16_t tail = txring_tail;
+	uint16_t used = (uint16_t)(txring_head - tail);
+	uint16_t chunk;
+	if(used == 0){
+		return;
+	}
+	chunk = (uint16_t)(TXRING_SIZE - (tail & TXRING_MASK));	//到物理尾部的连续长度
+	if(chunk > used){
+		chunk = used;
+	}
+	txring_active_len = chunk;
+	HAL_UART_Transmit_DMA(&huart2, &txring_buf[tail & TXRING_MASK], chunk);
+}
+
+/**
+ * @brief 复位发送环
+ */
+void txRingInit(void)
+{
+	txring_head = 0;
+	txring_tail = 0;
+	txring_active_len = 0;
+	txring_dropped = 0;
+}
+
+/**
+ * @brief 帧入队并在链路空闲时启动发送
+ * @param data 帧数据
+ * @param length 帧长度
+ * @return 1入队成功 0空间不足整帧丢弃（计入txring_dropped）
+ * @note 多个中断上下文均可调用，入队全程短临界区保护
+ */
+uint8_t txRingSend(const uint8_t *data, uint16_t length)
+{
+	uint16_t i;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if((uint16_t)(TXRING_SIZE - (uint16_t)(txring_head - txring_tail)) < length){
+		++txring_dropped;	//空间不足：整帧丢弃，保证输出流帧边界完整
+		if(primask == 0){
+			__enable_irq();
+		}
+		return 0;
+	}
+	for(i = 0; i < length; i++){
+		txring_buf[(uint16_t)(txring_head + i) & TXRING_MASK] = data[i];
+	}
+	txring_head = (uint16_t)(txring_head + length);
+	if(txring_active_len == 0){
+		txRingKick();	//链路空闲，立即启动DMA
+	}
+	if(primask == 0){
+		__enable_irq();
+	}
+	return 1;
+}
+
+/**
+ * @brief DMA发送完成处理：推进读指针并链式启动下一段
+ * @note 在huart2的发送完成回调中调用
+ */
+void txRingTxCplt(void)
+{
+	txring_tail = (uint16_t)(txring_tail + txring_active_len);
+	txring_active_len = 0;
+	txRingKick();
+}
+
+/**
+ * @brief 查询待发送字节数
+ */
+uint16_t txRingPending(void)
+{
+	return (uint16_t)(txring_head - txring_tail);
+}
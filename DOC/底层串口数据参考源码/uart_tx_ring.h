@@ -0,0 +1,26 @@
+#ifndef __UART_TX_RING_H
+#define __UART_TX_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "usart.h"
+
+// huart2上行发送环形缓冲区：所有生产者统一入队，DMA链式发出
+#define TXRING_SIZE 1024	//发送环长度（必须为2的幂）
+#define TXRING_MASK (TXRING_SIZE - 1)
+
+extern volatile uint32_t txring_dropped;	//缓冲区满被丢弃的帧计数
+
+void txRingInit(void);
+uint8_t txRingSend(const uint8_t *data, uint16_t length);
+void txRingTxCplt(void);
+uint16_t txRingPending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_TX_RING_H */
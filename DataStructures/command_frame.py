@@ -5,7 +5,7 @@
 
 import struct
 from dataclasses import dataclass
-from typing import Optional
+from typing import List, Optional
 
 
 @dataclass
@@ -37,11 +37,17 @@ class UartControl:
     
     # 激光器开启延时 (2字节)
     lidar_time: int = 0
-    
+
+    # 批量上传帧数 (2字节，1=逐帧发送)
+    upload_batch: int = 1
+
+    # 过采样抽取因子K (2字节，1=不抽取)
+    decim_factor: int = 1
+
     def to_bytes(self) -> bytes:
         """将控制参数转换为字节流"""
-        # 总字节数: 2*9 = 18字节
-        return struct.pack('>HHHHHHHHH',
+        # 总字节数: 2*11 = 22字节
+        return struct.pack('>HHHHHHHHHHH',
                           self.uart_upload_time,
                           self.adj_time,
                           self.fashion_time,
@@ -50,15 +56,17 @@ class UartControl:
                           self.pos_div,
                           self.pos_set,
                           self.flag_mask,
-                          self.lidar_time)
-    
+                          self.lidar_time,
+                          self.upload_batch,
+                          self.decim_factor)
+
     @classmethod
     def from_bytes(cls, data: bytes) -> 'UartControl':
         """从字节流解析控制参数"""
-        if len(data) != 18:
-            raise ValueError(f"控制参数长度应为18字节，实际收到{len(data)}字节")
-        
-        values = struct.unpack('>HHHHHHHHH', data)
+        if len(data) != 22:
+            raise ValueError(f"控制参数长度应为22字节，实际收到{len(data)}字节")
+
+        values = struct.unpack('>HHHHHHHHHHH', data)
         return cls(*values)
 
 
@@ -77,6 +85,17 @@ class CommandConstants:
     CMD_SET_SERVO_POS = 0x06  # 设置舵机运转位置参数
     CMD_SET_WORK_MODE = 0x07  # 设置工作模式
     CMD_SET_LIDAR_DELAY = 0x08  # 设置激光器开启延时
+    CMD_SET_UPLOAD_BATCH = 0x09  # 设置批量上传帧数
+    CMD_SET_DECIM_FACTOR = 0x0A  # 设置过采样抽取因子
+    CMD_COMMIT_PARAMS = 0x0B  # 提交当前参数到FLASH持久化
+    CMD_RESEND_FRAME = 0x0C  # 按(主帧,子帧)序号请求重传历史数据帧
+    CMD_READ_PERF_STATS = 0x0D  # 读取DWT性能统计诊断帧(0xA9 0xB6)
+    CMD_READ_BENCH_STATS = 0x0E  # 读取链路基准计数帧(0xA9 0xB7)
+    CMD_SET_BAUD = 0x0F  # 协商上行波特率(旧速率应答后切换，超时回退)
+    CMD_SET_DELTA_MODE = 0x10  # 协商差分紧凑帧(关键帧+变化位图，会话级)
+    CMD_SET_STATS_WINDOW = 0x18  # 设置幅值统计窗口样本数(0=关闭统计帧)
+    CMD_READ_COUNTERS = 0x19  # 查询链路计量计数器(可选每N帧自动上报)
+    CMD_READ_TIMEBASE = 0x1A  # 采样下位机微秒时基(钟差估计)
     
     # 调试指令
     CMD_DEBUG_IIC_READ = 0x11  # 调试IIC读命令
@@ -87,6 +106,13 @@ class CommandConstants:
     CMD_DEBUG_READ_DATA = 0x16  # 调试读取数据
     CMD_DEBUG_MONITOR_DATA = 0x17  # 调试监控数据
     
+    # 批量执行指令
+    CMD_BATCH = 0x30  # 一帧内按序执行多条子指令，单次应答
+
+    # 流式会话指令
+    CMD_STREAM_SESSION = 0x31  # 开启/关闭流式捕获会话(滑动窗口确认)
+    CMD_STREAM_ACK = 0x32  # 流式会话累计确认(回发窗口标记帧中的序号)
+
     # 带参数启动指令
     CMD_START_DEBUG_WITH_PARAMS = 0x21  # 带参数启动debug模式
     CMD_START_CMODE_WITH_PARAMS = 0x22  # 带参数启动cMode
@@ -181,6 +207,90 @@ class CommandDriver:
         data = struct.pack('>H', lidar_time)
         return CommandFrame(CommandConstants.CMD_SET_LIDAR_DELAY, data)
     
+    @staticmethod
+    def create_set_upload_batch_command(upload_batch: int) -> CommandFrame:
+        """创建设置批量上传帧数指令"""
+        data = struct.pack('>H', upload_batch)
+        return CommandFrame(CommandConstants.CMD_SET_UPLOAD_BATCH, data)
+
+    @staticmethod
+    def create_set_decim_factor_command(decim_factor: int) -> CommandFrame:
+        """创建设置过采样抽取因子指令"""
+        data = struct.pack('>H', decim_factor)
+        return CommandFrame(CommandConstants.CMD_SET_DECIM_FACTOR, data)
+
+    @staticmethod
+    def create_commit_params_command() -> CommandFrame:
+        """创建参数提交指令：将下位机当前参数固化到FLASH，上电自主恢复"""
+        return CommandFrame(CommandConstants.CMD_COMMIT_PARAMS)
+
+    @staticmethod
+    def create_resend_frame_command(master_frame: int, slave_frame: int) -> CommandFrame:
+        """创建重传请求指令：下位机在历史窗内命中(主帧,子帧)则补发该帧，未命中静默"""
+        data = struct.pack('>HH', master_frame, slave_frame)
+        return CommandFrame(CommandConstants.CMD_RESEND_FRAME, data)
+
+    @staticmethod
+    def create_read_perf_stats_command(reset_after: bool = False) -> CommandFrame:
+        """创建性能统计读取指令：下位机回0xA9 0xB6诊断帧，可选读取后清零"""
+        data = bytes([0x01 if reset_after else 0x00])
+        return CommandFrame(CommandConstants.CMD_READ_PERF_STATS, data)
+
+    @staticmethod
+    def create_read_bench_stats_command() -> CommandFrame:
+        """创建基准计数读取指令：下位机回0xA9 0xB7帧(提交帧数/实发帧数)"""
+        return CommandFrame(CommandConstants.CMD_READ_BENCH_STATS)
+
+    @staticmethod
+    def create_set_baud_command(baud: int) -> CommandFrame:
+        """创建波特率协商指令：下位机在旧速率回0xA9 0xB8应答后切换，
+        上位机需在新速率发送任意有效指令帧确认，否则下位机超时回退"""
+        data = struct.pack('>I', baud)
+        return CommandFrame(CommandConstants.CMD_SET_BAUD, data)
+
+    @staticmethod
+    def create_set_delta_mode_command(enable: bool, key_interval: int = 16) -> CommandFrame:
+        """创建差分紧凑帧协商指令：开启后每key_interval帧发一个完整关键帧(0xA9 0xB5)，
+        其余帧为变化位图+变化字段的紧凑帧(0xA9 0xB4)；不协商的老上位机始终收整帧"""
+        data = struct.pack('>HH', 1 if enable else 0, key_interval)
+        return CommandFrame(CommandConstants.CMD_SET_DELTA_MODE, data)
+
+    @staticmethod
+    def create_set_stats_window_command(window_samples: int) -> CommandFrame:
+        """创建幅值统计窗口指令：每window_samples个原始采样输出一帧
+        0xA9 0xB9统计帧(8通道min/max/均值/饱和计数)，0关闭"""
+        data = struct.pack('>H', window_samples)
+        return CommandFrame(CommandConstants.CMD_SET_STATS_WINDOW, data)
+
+    @staticmethod
+    def create_read_counters_command(report_period: int = 0) -> CommandFrame:
+        """创建计数器查询指令：立即回一帧0xA9 0xBA计数器帧
+        (产出/送出/各环节丢弃/舵机重试/I2C事务，各4字节小端)；
+        report_period>0时下位机另随数据流每N帧自动穿插一帧"""
+        data = struct.pack('>H', report_period)
+        return CommandFrame(CommandConstants.CMD_READ_COUNTERS, data)
+
+    @staticmethod
+    def create_read_timebase_command() -> CommandFrame:
+        """创建时基采样指令：下位机回0xA9 0xBB帧携带当前微秒时基读数，
+        上位机往返采样若干次即可估计钟差(时基在72MHz下约59.6秒回绕)"""
+        return CommandFrame(CommandConstants.CMD_READ_TIMEBASE, b'')
+
+    @staticmethod
+    def create_stream_session_command(enable: bool, window: int = 32) -> CommandFrame:
+        """创建流式会话指令：开启后下位机每window帧穿插一个0xA9 0xBC
+        窗口标记帧(累计序号+补发计数)，上位机按标记回发累计确认；
+        未确认帧在重传历史窗被覆盖前由下位机主动补发"""
+        data = struct.pack('>HH', 1 if enable else 0, window)
+        return CommandFrame(CommandConstants.CMD_STREAM_SESSION, data)
+
+    @staticmethod
+    def create_stream_ack_command(sequence: int) -> CommandFrame:
+        """创建流式会话累计确认：sequence取自最近一个窗口标记帧，
+        表示该序号之前的帧已全部收妥"""
+        data = struct.pack('>H', sequence)
+        return CommandFrame(CommandConstants.CMD_STREAM_ACK, data)
+
     @staticmethod
     def create_debug_iic_read_command(addr_index: int) -> CommandFrame:
         """创建调试IIC读命令"""
@@ -236,6 +346,15 @@ class CommandDriver:
         data = struct.pack('>HHHHH', flag_mask, pos_low, pos_high, fashion_time, lidar_time)
         return CommandFrame(CommandConstants.CMD_START_CMODE_WITH_PARAMS, data)
 
+    @staticmethod
+    def create_batch_command(sub_commands: List[CommandFrame]) -> CommandFrame:
+        """创建批量执行指令：多条子指令打包进一帧，按序执行并保留各自副作用，单次应答"""
+        data = bytearray([len(sub_commands)])
+        for sub in sub_commands:
+            data.append(sub.command_type)
+            data.extend(sub.data)
+        return CommandFrame(CommandConstants.CMD_BATCH, bytes(data))
+
 
 # 指令帧长度常量
 CMD_FRAME_HEADER_LENGTH = 3  # 帧头2字节 + 指令类型1字节
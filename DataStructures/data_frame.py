@@ -12,6 +12,34 @@ import time
 from datetime import datetime
 from DataParser.circular_buffer import CircularBuffer, BufferType
 
+# 数据帧长度（含帧头、抽取因子、微秒时间戳、CRC校验字节和帧尾）
+DATA_FRAME_SIZE = 46
+
+
+def calc_frame_crc8(data: bytes) -> int:
+    """
+    计算数据帧CRC校验值
+
+    与下位机硬件CRC外设一致：CRC-8，多项式0x07，初值0xFF，
+    覆盖帧内字节2..43（即去掉帧头后的前42字节）
+
+    Args:
+        data: 参与校验的字节序列
+
+    Returns:
+        CRC校验值 (0-255)
+    """
+    crc = 0xFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            if crc & 0x80:
+                crc = ((crc << 1) ^ 0x07) & 0xFF
+            else:
+                crc = (crc << 1) & 0xFF
+    return crc
+
+
 @dataclass
 class ChannelData:
     """单个通道的数据结构"""
@@ -38,9 +66,18 @@ class DataFrame:
     # 子帧数据 (2字节)
     slave_frame: int = 0
     
-    # 激光器状态 (1字节)
+    # 激光器状态 (1字节低7位)
     lidar_state: int = 0
-    
+
+    # 下位机是否由FLASH配置自主启动 (激光器状态字节bit7)
+    configured_boot: int = 0
+
+    # 过采样抽取因子K (1字节，本帧由K个原始采样平均得出)
+    decim_factor: int = 1
+
+    # 采样微秒时间戳 (4字节，SDADC交付时刻锁存；72MHz下约59.6秒回绕)
+    timestamp_us: int = 0
+
     # 帧尾 (1字节)
     frame_tail: bytes = b'\x33'
     
@@ -61,6 +98,8 @@ class DataFrame:
         result.append(f"主帧: {self.master_frame}")
         result.append(f"子帧: {self.slave_frame}")
         result.append(f"激光器状态: {self.lidar_state}")
+        result.append(f"抽取因子: {self.decim_factor}")
+        result.append(f"时间戳: {self.timestamp_us}us")
         result.append(f"帧尾: {self.frame_tail.hex()}")
         
         return "\n".join(result)
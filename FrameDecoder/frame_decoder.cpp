@@ -0,0 +1,132 @@
+#include "frame_decoder.h"
+
+#include <cstring>
+
+namespace framedecoder {
+
+std::uint8_t CalcCrc8(const std::uint8_t *data, std::size_t length) {
+    std::uint8_t crc = 0xFF;
+    for (std::size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            if (crc & 0x80) {
+                crc = static_cast<std::uint8_t>((crc << 1) ^ 0x07);
+            } else {
+                crc = static_cast<std::uint8_t>(crc << 1);
+            }
+        }
+    }
+    return crc;
+}
+
+namespace {
+
+/**
+ * 将一条已校验的帧展开为列字段
+ */
+void Unpack(const std::uint8_t *frame, FrameFields *out) {
+    FrameView view(frame);
+    for (std::size_t ch = 0; ch < 4; ++ch) {
+        out->adc[ch] = view.adc(ch);
+    }
+    for (std::size_t ch = 0; ch < 8; ++ch) {
+        out->sdadc[ch] = view.sdadc(ch);
+        out->adj[ch] = view.adj(ch);
+    }
+    out->master = view.master();
+    out->pos = view.pos();
+    out->lidar = view.lidar();
+    out->configured_boot = view.configured_boot() ? 1 : 0;
+    out->decim = view.decim();
+    out->reserved = 0;
+    out->timestamp_us = view.timestamp_us();
+}
+
+}  // namespace
+
+std::size_t FrameScanner::Feed(const std::uint8_t *data, std::size_t length) {
+    // 残留字节与新数据拼接后统一扫描；残留最多kFrameSize-1字节，
+    // 拷贝代价相对解码可忽略，扫描与字段读取全部就地进行
+    buf_.insert(buf_.end(), data, data + length);
+
+    std::size_t pos = 0;
+    std::size_t decoded = 0;
+    while (buf_.size() - pos >= kFrameSize) {
+        const std::uint8_t *p = buf_.data() + pos;
+        if (p[0] != kHeader0 || p[1] != kHeader1) {
+            ++pos;
+            ++resync_bytes_;
+            continue;
+        }
+        if (CalcCrc8(p + 2, 42) != p[44]) {
+            ++crc_errors_;
+            ++pos;
+            continue;
+        }
+        batch_.emplace_back();
+        Unpack(p, &batch_.back());
+        ++decoded;
+        pos += kFrameSize;
+    }
+    buf_.erase(buf_.begin(), buf_.begin() + pos);
+    return decoded;
+}
+
+std::size_t FrameScanner::Take(FrameFields *out, std::size_t max_frames) {
+    std::size_t available = batch_.size() - batch_taken_;
+    std::size_t count = (max_frames < available) ? max_frames : available;
+    if (count != 0) {
+        std::memcpy(out, batch_.data() + batch_taken_,
+                    count * sizeof(FrameFields));
+        batch_taken_ += count;
+    }
+    if (batch_taken_ == batch_.size()) {
+        batch_.clear();
+        batch_taken_ = 0;
+    }
+    return count;
+}
+
+}  // namespace framedecoder
+
+// ---------------------------------------------------------------------------
+// C接口实现
+// ---------------------------------------------------------------------------
+extern "C" {
+
+void *fd_scanner_new(void) { return new framedecoder::FrameScanner(); }
+
+void fd_scanner_free(void *scanner) {
+    delete static_cast<framedecoder::FrameScanner *>(scanner);
+}
+
+std::size_t fd_scanner_feed(void *scanner, const std::uint8_t *data,
+                            std::size_t length) {
+    return static_cast<framedecoder::FrameScanner *>(scanner)->Feed(data,
+                                                                    length);
+}
+
+std::size_t fd_scanner_take(void *scanner, fd_frame_fields *out,
+                            std::size_t max_frames) {
+    static_assert(sizeof(fd_frame_fields) ==
+                      sizeof(framedecoder::FrameFields),
+                  "C接口字段布局须与FrameFields一致");
+    return static_cast<framedecoder::FrameScanner *>(scanner)->Take(
+        reinterpret_cast<framedecoder::FrameFields *>(out), max_frames);
+}
+
+std::size_t fd_scanner_pending(const void *scanner) {
+    return static_cast<const framedecoder::FrameScanner *>(scanner)->pending();
+}
+
+std::uint64_t fd_scanner_crc_errors(const void *scanner) {
+    return static_cast<const framedecoder::FrameScanner *>(scanner)
+        ->crc_errors();
+}
+
+std::uint64_t fd_scanner_resync_bytes(const void *scanner) {
+    return static_cast<const framedecoder::FrameScanner *>(scanner)
+        ->resync_bytes();
+}
+
+}  // extern "C"
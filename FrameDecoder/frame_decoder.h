@@ -0,0 +1,154 @@
+/**
+ * 上传数据帧原生解码库
+ *
+ * 镜像下位机uploadBuildFrame()的46字节帧布局：
+ *   0-1   帧头0xA9 0xB5
+ *   2-9   4ch adc (小端u16)
+ *   10-25 8ch sdadc (小端i16)
+ *   26-33 8ch autoadj (u8)
+ *   34-35 主帧序号 (小端u16)
+ *   36-37 子帧序号 (小端u16)
+ *   38    激光器状态 (bit7为FLASH配置自主启动标志)
+ *   39    过采样抽取因子K
+ *   40-43 采样微秒时间戳 (小端u32，SDADC交付时刻锁存)
+ *   44    CRC-8 (多项式0x07 初值0xFF，覆盖字节2..43)
+ *   45    帧尾0x33
+ *
+ * C++侧提供零拷贝帧视图与增量扫描器；底部的C接口供Python经ctypes绑定，
+ * 替代simple_uart.py中逐字节、逐字段的纯Python解析路径。
+ */
+#ifndef FRAME_DECODER_H
+#define FRAME_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace framedecoder {
+
+constexpr std::size_t kFrameSize = 46;
+constexpr std::uint8_t kHeader0 = 0xA9;
+constexpr std::uint8_t kHeader1 = 0xB5;
+constexpr std::uint8_t kTrailer = 0x33;
+
+/**
+ * 计算帧CRC校验值（与下位机硬件CRC外设一致）
+ */
+std::uint8_t CalcCrc8(const std::uint8_t *data, std::size_t length);
+
+/**
+ * 零拷贝帧视图：只持有指向一条已校验帧首字节的指针，字段按需就地读取，
+ * 不产生任何堆分配。指针生命周期由调用方的缓冲区保证。
+ */
+class FrameView {
+public:
+    explicit FrameView(const std::uint8_t *frame) : frame_(frame) {}
+
+    std::uint16_t adc(std::size_t ch) const { return ReadU16(2 + ch * 2); }
+    std::int16_t sdadc(std::size_t ch) const {
+        return static_cast<std::int16_t>(ReadU16(10 + ch * 2));
+    }
+    std::uint8_t adj(std::size_t ch) const { return frame_[26 + ch]; }
+    std::uint16_t master() const { return ReadU16(34); }
+    std::uint16_t pos() const { return ReadU16(36); }
+    std::uint8_t lidar() const { return frame_[38] & 0x7F; }
+    bool configured_boot() const { return (frame_[38] & 0x80) != 0; }
+    std::uint8_t decim() const { return frame_[39]; }
+    std::uint32_t timestamp_us() const {
+        return static_cast<std::uint32_t>(frame_[40]) |
+               (static_cast<std::uint32_t>(frame_[41]) << 8) |
+               (static_cast<std::uint32_t>(frame_[42]) << 16) |
+               (static_cast<std::uint32_t>(frame_[43]) << 24);
+    }
+    const std::uint8_t *data() const { return frame_; }
+
+private:
+    std::uint16_t ReadU16(std::size_t offset) const {
+        return static_cast<std::uint16_t>(frame_[offset] |
+                                          (frame_[offset + 1] << 8));
+    }
+
+    const std::uint8_t *frame_;
+};
+
+/**
+ * 解码后的帧字段，按列连续排布，供批量导出。
+ * 布局与C接口的fd_frame_fields保持一致（见文件底部）。
+ */
+struct FrameFields {
+    std::uint16_t adc[4];
+    std::int16_t sdadc[8];
+    std::uint8_t adj[8];
+    std::uint16_t master;
+    std::uint16_t pos;
+    std::uint8_t lidar;
+    std::uint8_t configured_boot;
+    std::uint8_t decim;
+    std::uint8_t reserved;  // 对齐占位
+    std::uint32_t timestamp_us;
+};
+
+/**
+ * 增量帧扫描器：接收任意切分的字节流，就地定位帧头、校验CRC，
+ * 解码帧积累在连续批量缓冲中等待取走。帧头或CRC不匹配时逐字节
+ * 滑动重同步；跨feed边界的残帧保留到下一次feed继续凑齐。
+ */
+class FrameScanner {
+public:
+    /**
+     * 送入一段接收数据
+     * @return 本次新解码的完整帧数
+     */
+    std::size_t Feed(const std::uint8_t *data, std::size_t length);
+
+    /**
+     * 取走批量缓冲中最早的帧（连续内存块拷出）
+     * @return 实际取走的帧数
+     */
+    std::size_t Take(FrameFields *out, std::size_t max_frames);
+
+    std::uint64_t crc_errors() const { return crc_errors_; }
+    std::uint64_t resync_bytes() const { return resync_bytes_; }
+    std::size_t pending() const { return batch_.size() - batch_taken_; }
+
+private:
+    std::vector<std::uint8_t> buf_;       // 跨feed残留字节
+    std::vector<FrameFields> batch_;      // 已解码待取走的帧
+    std::size_t batch_taken_ = 0;         // batch_中已取走的帧数
+    std::uint64_t crc_errors_ = 0;        // CRC校验失败次数
+    std::uint64_t resync_bytes_ = 0;      // 重同步时跳过的字节数
+};
+
+}  // namespace framedecoder
+
+// ---------------------------------------------------------------------------
+// C接口：供Python ctypes绑定（见frame_decoder.py）
+// ---------------------------------------------------------------------------
+extern "C" {
+
+typedef struct {
+    std::uint16_t adc[4];
+    std::int16_t sdadc[8];
+    std::uint8_t adj[8];
+    std::uint16_t master;
+    std::uint16_t pos;
+    std::uint8_t lidar;
+    std::uint8_t configured_boot;
+    std::uint8_t decim;
+    std::uint8_t reserved;
+    std::uint32_t timestamp_us;
+} fd_frame_fields;
+
+void *fd_scanner_new(void);
+void fd_scanner_free(void *scanner);
+std::size_t fd_scanner_feed(void *scanner, const std::uint8_t *data,
+                            std::size_t length);
+std::size_t fd_scanner_take(void *scanner, fd_frame_fields *out,
+                            std::size_t max_frames);
+std::size_t fd_scanner_pending(const void *scanner);
+std::uint64_t fd_scanner_crc_errors(const void *scanner);
+std::uint64_t fd_scanner_resync_bytes(const void *scanner);
+
+}  // extern "C"
+
+#endif  // FRAME_DECODER_H
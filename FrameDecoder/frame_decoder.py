@@ -0,0 +1,213 @@
+"""
+上传数据帧原生解码库的Python绑定
+
+经ctypes调用libframedecoder.so：字节流扫描、CRC校验与字段展开全部
+在原生代码中完成，Python侧只在需要时把批量结果转换为DataFrame对象，
+替代simple_uart.py中逐字节、逐字段的纯Python解析路径。
+
+使用前先在本目录执行 make 生成 libframedecoder.so。
+"""
+
+import ctypes
+import os
+from typing import List, Optional
+
+
+class FdFrameFields(ctypes.Structure):
+    """解码后的帧字段，与C接口的fd_frame_fields布局一致"""
+    _fields_ = [
+        ("adc", ctypes.c_uint16 * 4),
+        ("sdadc", ctypes.c_int16 * 8),
+        ("adj", ctypes.c_uint8 * 8),
+        ("master", ctypes.c_uint16),
+        ("pos", ctypes.c_uint16),
+        ("lidar", ctypes.c_uint8),
+        ("configured_boot", ctypes.c_uint8),
+        ("decim", ctypes.c_uint8),
+        ("reserved", ctypes.c_uint8),
+        ("timestamp_us", ctypes.c_uint32),
+    ]
+
+
+def _load_library() -> ctypes.CDLL:
+    """加载同目录下的解码动态库"""
+    lib_path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            "libframedecoder.so")
+    if not os.path.exists(lib_path):
+        raise FileNotFoundError(
+            f"未找到 {lib_path}，请先在FrameDecoder目录执行 make 构建")
+    lib = ctypes.CDLL(lib_path)
+    lib.fd_scanner_new.restype = ctypes.c_void_p
+    lib.fd_scanner_free.argtypes = [ctypes.c_void_p]
+    lib.fd_scanner_feed.restype = ctypes.c_size_t
+    lib.fd_scanner_feed.argtypes = [ctypes.c_void_p, ctypes.c_char_p,
+                                    ctypes.c_size_t]
+    lib.fd_scanner_take.restype = ctypes.c_size_t
+    lib.fd_scanner_take.argtypes = [ctypes.c_void_p,
+                                    ctypes.POINTER(FdFrameFields),
+                                    ctypes.c_size_t]
+    lib.fd_scanner_pending.restype = ctypes.c_size_t
+    lib.fd_scanner_pending.argtypes = [ctypes.c_void_p]
+    lib.fd_scanner_crc_errors.restype = ctypes.c_uint64
+    lib.fd_scanner_crc_errors.argtypes = [ctypes.c_void_p]
+    lib.fd_scanner_resync_bytes.restype = ctypes.c_uint64
+    lib.fd_scanner_resync_bytes.argtypes = [ctypes.c_void_p]
+    return lib
+
+
+class NativeFrameDecoder:
+    """原生帧解码器：feed送入任意切分的接收数据，take批量取走解码帧"""
+
+    def __init__(self):
+        self._lib = _load_library()
+        self._scanner = self._lib.fd_scanner_new()
+
+    def close(self):
+        """释放原生扫描器"""
+        if self._scanner:
+            self._lib.fd_scanner_free(self._scanner)
+            self._scanner = None
+
+    def __del__(self):
+        try:
+            self.close()
+        except Exception:
+            pass
+
+    def feed(self, data: bytes) -> int:
+        """送入一段接收数据，返回本次新解码的完整帧数"""
+        return self._lib.fd_scanner_feed(self._scanner, data, len(data))
+
+    def take(self, max_frames: Optional[int] = None) -> List[FdFrameFields]:
+        """取走已解码的帧（连续内存批量拷出）"""
+        if max_frames is None:
+            max_frames = self.pending()
+        if max_frames <= 0:
+            return []
+        out = (FdFrameFields * max_frames)()
+        count = self._lib.fd_scanner_take(self._scanner, out, max_frames)
+        return list(out[:count])
+
+    def pending(self) -> int:
+        """已解码待取走的帧数"""
+        return self._lib.fd_scanner_pending(self._scanner)
+
+    @property
+    def crc_errors(self) -> int:
+        """CRC校验失败次数"""
+        return self._lib.fd_scanner_crc_errors(self._scanner)
+
+    @property
+    def resync_bytes(self) -> int:
+        """重同步时跳过的字节数"""
+        return self._lib.fd_scanner_resync_bytes(self._scanner)
+
+
+def fields_to_data_frame(fields: FdFrameFields):
+    """将解码字段转换为DataFrame对象（通道映射与simple_uart解析一致），
+    既有的显示/落盘订阅者无需改动"""
+    from DataStructures.data_frame import DataFrame
+
+    def _signed(value: int) -> int:
+        return value - 0x10000 if value >= 0x8000 else value
+
+    frame = DataFrame()
+    # adc[2134]
+    adc_channel_map = [1, 0, 2, 3]
+    for i in range(4):
+        frame.channels[adc_channel_map[i]].adc = _signed(fields.adc[i])
+    # sdadc[CH1A,CH2A,CH3A,CH1B,CH2B,CH4A,CH3B,CH4B]
+    frame.channels[0].sdadc0 = fields.sdadc[0]
+    frame.channels[1].sdadc0 = fields.sdadc[1]
+    frame.channels[2].sdadc0 = fields.sdadc[2]
+    frame.channels[0].sdadc1 = fields.sdadc[3]
+    frame.channels[1].sdadc1 = fields.sdadc[4]
+    frame.channels[3].sdadc0 = fields.sdadc[5]
+    frame.channels[2].sdadc1 = fields.sdadc[6]
+    frame.channels[3].sdadc1 = fields.sdadc[7]
+    for i in range(4):
+        frame.channels[i].adj0 = fields.adj[i]
+        frame.channels[i].adj1 = fields.adj[4 + i]
+        frame.channels[i].current = (1000 * (frame.channels[i].sdadc0 + 32767)
+                                     * 3300 / 65535) / (
+            (256 - frame.channels[i].adj0) * 3.92)
+    frame.master_frame = fields.master
+    frame.slave_frame = fields.pos
+    frame.lidar_state = fields.lidar
+    frame.configured_boot = fields.configured_boot
+    frame.decim_factor = fields.decim if fields.decim > 0 else 1
+    frame.timestamp_us = fields.timestamp_us
+    return frame
+
+
+def _test_native_decoder():
+    """原生解码器自测：构造帧、切分喂入、校验字段与统计计数"""
+    import struct
+    import time
+
+    def crc8(data: bytes) -> int:
+        crc = 0xFF
+        for byte in data:
+            crc ^= byte
+            for _ in range(8):
+                crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 \
+                    else (crc << 1) & 0xFF
+        return crc
+
+    def build_frame(master: int, pos: int) -> bytes:
+        body = struct.pack('<4H', 100, 200, 300, 400)
+        body += struct.pack('<8h', -1, -2, -3, -4, 5, 6, 7, 8)
+        body += bytes(range(8))
+        body += struct.pack('<HH', master, pos)
+        body += bytes([0x85, 2])  # 激光器掩码5 + 配置启动位 | 抽取因子2
+        body += struct.pack('<I', 123456)  # 微秒时间戳
+        return b'\xA9\xB5' + body + bytes([crc8(body)]) + b'\x33'
+
+    print("=== 原生帧解码器测试 ===")
+    decoder = NativeFrameDecoder()
+
+    # 带噪声前缀与跨feed切分的三帧
+    stream = b'\x00\xA9\x55' + build_frame(1, 10) + build_frame(1, 11)
+    stream += b'\xFF' + build_frame(2, 0)
+    total = 0
+    for cut in (7, 50, len(stream)):
+        total += decoder.feed(stream[:cut])
+        stream = stream[cut:]
+    assert total == 3, f"期望解码3帧，实际{total}"
+    frames = decoder.take()
+    assert len(frames) == 3
+    assert frames[0].master == 1 and frames[0].pos == 10
+    assert frames[2].master == 2 and frames[2].pos == 0
+    assert list(frames[0].adc) == [100, 200, 300, 400]
+    assert frames[0].sdadc[0] == -1 and frames[0].sdadc[7] == 8
+    assert frames[0].lidar == 5 and frames[0].configured_boot == 1
+    assert frames[0].decim == 2
+    assert frames[0].timestamp_us == 123456
+    assert decoder.resync_bytes == 4  # 3字节噪声前缀 + 帧间1字节
+    print("字段与重同步校验通过")
+
+    # CRC损坏帧被拒绝并计数
+    bad = bytearray(build_frame(3, 3))
+    bad[5] ^= 0xFF
+    decoder.feed(bytes(bad))
+    assert decoder.pending() == 0
+    assert decoder.crc_errors >= 1
+    print("CRC拒绝计数通过")
+
+    # 吞吐量基准
+    batch = b''.join(build_frame(i >> 8, i & 0xFF) for i in range(1000))
+    start = time.perf_counter()
+    rounds = 100
+    for _ in range(rounds):
+        decoder.feed(batch)
+        decoder.take()
+    elapsed = time.perf_counter() - start
+    rate = rounds * 1000 / elapsed
+    print(f"吞吐量: {rate:,.0f} 帧/秒")
+
+    decoder.close()
+    print("=== 测试完成 ===")
+
+
+if __name__ == "__main__":
+    _test_native_decoder()
@@ -10,7 +10,7 @@ import threading
 import time
 from typing import Optional, Callable, List
 from DataParser.circular_buffer import CircularBuffer, BufferType
-from DataStructures.data_frame import DataFrame, ChannelData, DataFramePublisher, DataFrameFileWriter
+from DataStructures.data_frame import DataFrame, ChannelData, DataFramePublisher, DataFrameFileWriter, calc_frame_crc8
 
 
 class SimpleUart:
@@ -50,6 +50,9 @@ class SimpleUart:
         self.rx_bytes = 0
         self.tx_bytes = 0
         self.errors = 0
+
+        # 差分紧凑帧重建基准：最近一帧完整帧的前42字节内容
+        self._delta_base: Optional[bytes] = None
     
     def open(self) -> bool:
         """打开串口连接"""
@@ -255,16 +258,19 @@ class SimpleUart:
 
 
     def _parse_data_frame(self, frame_data: bytes):
-        """解析数据帧 - 传入的是去掉帧头的38字节数据"""
+        """解析数据帧 - 传入的是去掉帧头的44字节数据(已通过CRC校验)"""
         try:
-            # 数据帧结构(去掉帧头A9B5后): ADC数据(8字节) + SDADC数据(16字节) + ADJ数据(8字节) + 主帧(2字节) + 子帧(2字节) + 激光器状态(1字节) + 帧尾(1字节)
+            # 数据帧结构(去掉帧头A9B5后): ADC数据(8字节) + SDADC数据(16字节) + ADJ数据(8字节) + 主帧(2字节) + 子帧(2字节) + 激光器状态(1字节) + 抽取因子(1字节) + 微秒时间戳(4字节) + CRC(1字节) + 帧尾(1字节)
             # ADC数据: 4通道，每通道2字节 = 8字节 (字节0-7)
-            # SDADC数据: 8通道，每通道2字节 = 16字节 (字节8-23) 
+            # SDADC数据: 8通道，每通道2字节 = 16字节 (字节8-23)
             # ADJ数据: 8通道，每通道1字节 = 8字节 (字节24-31)
             # 主帧: 2字节 (字节32-33)
             # 子帧: 2字节 (字节34-35)
             # 激光器状态: 1字节 (字节36)
-            # 帧尾: 1字节 (字节37)
+            # 抽取因子K: 1字节 (字节37)
+            # 微秒时间戳: 4字节 (字节38-41)
+            # CRC: 1字节 (字节42)
+            # 帧尾: 1字节 (字节43)
             
             # 创建数据帧对象
             data_frame = DataFrame()
@@ -306,12 +312,19 @@ class SimpleUart:
             # 解析子帧数据 (2字节)
             data_frame.slave_frame = int.from_bytes(frame_data[34:36], byteorder='little')
             
-            # 解析激光器状态 (1字节)
-            data_frame.lidar_state = frame_data[36]
-            
+            # 解析激光器状态 (1字节，bit7为FLASH配置自主启动标志)
+            data_frame.lidar_state = frame_data[36] & 0x7F
+            data_frame.configured_boot = 1 if frame_data[36] & 0x80 else 0
+
+            # 解析过采样抽取因子 (1字节，上位机据此换算有效采样率)
+            data_frame.decim_factor = frame_data[37] if frame_data[37] > 0 else 1
+
+            # 解析采样微秒时间戳 (4字节，SDADC交付时刻锁存)
+            data_frame.timestamp_us = int.from_bytes(frame_data[38:42], byteorder='little')
+
             # 验证帧尾是否为0x33
-            if frame_data[37] != 0x33:
-                self._handle_error(f"帧尾错误: 期望0x33，实际{frame_data[37]:02X}")
+            if frame_data[43] != 0x33:
+                self._handle_error(f"帧尾错误: 期望0x33，实际{frame_data[43]:02X}")
                 return
             
             # 发布数据帧到订阅者
@@ -326,6 +339,39 @@ class SimpleUart:
         except Exception as e:
             self._handle_error(f"解析数据帧错误: {e}")
 
+    def _parse_delta_frame(self, bitmap: int, body: bytes):
+        """解析差分紧凑帧 - 在最近一帧完整帧(关键帧)的基础上应用变化字段后复用整帧解析"""
+        if self._delta_base is None:
+            print("差分帧先于关键帧到达，丢弃并等待下一关键帧")
+            return
+        frame = bytearray(self._delta_base)
+        offset = 0
+        # adc通道: 帧内字节2*i起各2字节
+        for i in range(4):
+            if bitmap & (1 << i):
+                frame[2 * i:2 * i + 2] = body[offset:offset + 2]
+                offset += 2
+        # sdadc通道: 帧内字节8+2*i起各2字节
+        for i in range(8):
+            if bitmap & (1 << (4 + i)):
+                frame[8 + 2 * i:8 + 2 * i + 2] = body[offset:offset + 2]
+                offset += 2
+        # adj整组: 帧内字节24-31
+        if bitmap & 0x1000:
+            frame[24:32] = body[offset:offset + 8]
+            offset += 8
+        # 激光器状态+抽取因子: 帧内字节36-37
+        if bitmap & 0x2000:
+            frame[36:38] = body[offset:offset + 2]
+            offset += 2
+        # 主帧/子帧序号与微秒时间戳恒带: 帧内字节32-35和38-41
+        frame[32:36] = body[offset:offset + 4]
+        offset += 4
+        frame[38:42] = body[offset:offset + 4]
+        self._delta_base = bytes(frame)
+        # 重建为整帧布局后复用整帧解析(CRC已在环节前校验，补0占位+帧尾)
+        self._parse_data_frame(bytes(frame) + bytes([0x00, 0x33]))
+
     def _handle_error(self, error_msg: str):
         """处理错误"""
         self.errors += 1
@@ -360,17 +406,43 @@ class SimpleUart:
                     
                     case 1:  # 寻找数据帧第二个帧头字节B5
                         if current_byte == 0xB5:  # 找到完整帧头A9 B5
-                            # 等待剩余38字节数据
-                            while self.running and self.rx_buffer.get_available() < 38:
+                            # 等待剩余44字节数据(含抽取因子、微秒时间戳、CRC和帧尾)
+                            while self.running and self.rx_buffer.get_available() < 44:
                                 time.sleep(0.0001)
 
                             # 读取剩余数据
-                            remaining_data = self.rx_buffer.read(38)
-                            # 验证帧尾解析数据帧
-                            if remaining_data[-1] == 0x33:
+                            remaining_data = self.rx_buffer.read(44)
+                            # CRC校验通过即认为整帧有效，无需依赖帧尾重新扫描
+                            if calc_frame_crc8(remaining_data[0:42]) == remaining_data[42]:
+                                self._delta_base = remaining_data[0:42]  # 更新差分重建基准
                                 self._parse_data_frame(remaining_data)
                             else:
-                                print(f"数据帧帧尾错误: {remaining_data[-1]:02X}")
+                                print(f"数据帧CRC校验错误: 期望{calc_frame_crc8(remaining_data[0:42]):02X}，"
+                                      f"实际{remaining_data[42]:02X}")
+                            frame_state = 0  # 重置状态，寻找下一帧
+                        elif current_byte == 0xB4:  # 差分紧凑帧(关键帧间的变化字段)
+                            # 读取2字节变化位图
+                            while self.running and self.rx_buffer.get_available() < 2:
+                                time.sleep(0.0001)
+                            bitmap_bytes = self.rx_buffer.read(2)
+                            bitmap = bitmap_bytes[0] | (bitmap_bytes[1] << 8)
+                            # 按位图计算变化字段长度: adc/sdadc每通道2字节，adj整组8字节，激光器+抽取因子2字节
+                            field_len = 2 * bin(bitmap & 0x0FFF).count('1')
+                            if bitmap & 0x1000:
+                                field_len += 8
+                            if bitmap & 0x2000:
+                                field_len += 2
+                            # 变化字段 + 主帧/子帧/时间戳(恒带8字节) + CRC + 帧尾
+                            total_needed = field_len + 8 + 2
+                            while self.running and self.rx_buffer.get_available() < total_needed:
+                                time.sleep(0.0001)
+                            body = self.rx_buffer.read(total_needed)
+                            # CRC覆盖位图与帧尾CRC之前的全部字节
+                            if calc_frame_crc8(bitmap_bytes + body[0:field_len + 8]) == body[field_len + 8]:
+                                self._parse_delta_frame(bitmap, body)
+                            else:
+                                print(f"差分帧CRC校验错误: 期望{calc_frame_crc8(bitmap_bytes + body[0:field_len + 8]):02X}，"
+                                      f"实际{body[field_len + 8]:02X}")
                             frame_state = 0  # 重置状态，寻找下一帧
                         elif current_byte == 0xA9:  # 又遇到A9，可能是新帧的开始
                             # 保持状态为1，继续寻找B5